@@ -1,218 +1,135 @@
 // Copyright 2020 iniVation AG
+#define DV_API_OPENCV_SUPPORT 0
+
 #include "aedat4_convert.hpp"
+#include "aedat4_converter.hpp"
 
-#define DV_API_OPENCV_SUPPORT 0
+#include <algorithm>
+#include <chrono>
+#include <memory>
 
-#include "dv-sdk/data/event.hpp"
-#include "dv-sdk/data/frame.hpp"
-#include "dv-sdk/data/imu.hpp"
-#include "dv-sdk/data/trigger.hpp"
+int64_t dvConvertHostClock(void) {
+	auto now = std::chrono::steady_clock::now().time_since_epoch();
 
-#include <libcaercpp/events/frame.hpp>
-#include <libcaercpp/events/imu6.hpp>
-#include <libcaercpp/events/polarity.hpp>
-#include <libcaercpp/events/special.hpp>
+	return (std::chrono::duration_cast<std::chrono::microseconds>(now).count());
+}
 
-void dvConvertToAedat4(caerEventPacketHeaderConst oldPacket, dvModuleData moduleData) {
-	if (oldPacket == nullptr || moduleData == nullptr) {
-		return;
+static inline void commitTimed(
+	dvModuleData moduleData, const char *name, int64_t newestTimestamp, struct dvConvertTimings *timings) {
+	if (timings != nullptr) {
+		timings->converted       = dvConvertHostClock();
+		timings->newestTimestamp = newestTimestamp;
 	}
 
-	if (caerEventPacketHeaderGetEventValid(oldPacket) <= 0) {
-		// No valid events, nothing to do.
-		return;
+	dvModuleOutputCommit(moduleData, name);
+
+	if (timings != nullptr) {
+		timings->committed = dvConvertHostClock();
 	}
+}
 
-	switch (caerEventPacketHeaderGetEventType(oldPacket)) {
-		case POLARITY_EVENT: {
-			auto newObject      = dvModuleOutputAllocate(moduleData, "events");
-			auto newEventPacket = static_cast<dv::EventPacket *>(newObject->obj);
+void dvConvertToAedat4(caerEventPacketHeaderConst oldPacket, dvModuleData moduleData) {
+	dvConvertToAedat4Timed(oldPacket, moduleData, nullptr);
+}
 
-			const libcaer::events::PolarityEventPacket oldPacketPolarity(
-				const_cast<caerEventPacketHeader>(oldPacket), false);
+void dvConvertToAedat4Timed(
+	caerEventPacketHeaderConst oldPacket, dvModuleData moduleData, struct dvConvertTimings *timings) {
+	dvConvertToAedat4Range(oldPacket, 0, INT32_MAX, moduleData, timings);
+}
 
-			newEventPacket->elements.reserve(static_cast<size_t>(oldPacketPolarity.getEventValid()));
+template<int16_t EventType>
+static inline void convertToOutput(caerEventPacketHeaderConst oldPacket, int32_t begin, int32_t end,
+	dvModuleData moduleData, struct dvConvertTimings *timings, const struct dvConvertOptions &options) {
+	using Converter = Aedat4Convert::Converter<EventType>;
 
-			for (const auto &evt : oldPacketPolarity) {
-				if (!evt.isValid()) {
-					continue;
-				}
+	if constexpr (EventType == FRAME_EVENT) {
+		// One output object per frame.
+		end = std::min(end, caerEventPacketHeaderGetEventNumber(oldPacket));
 
-				newEventPacket->elements.emplace_back(
-					evt.getTimestamp64(oldPacketPolarity), evt.getX(), evt.getY(), evt.getPolarity());
+		for (int32_t i = begin; i < end; i++) {
+			if (!caerFrameEventIsValid(
+					caerFrameEventPacketGetEventConst(reinterpret_cast<caerFrameEventPacketConst>(oldPacket), i))) {
+				continue;
 			}
 
-			if (newEventPacket->elements.size() > 0) {
-				dvModuleOutputCommit(moduleData, "events");
-			}
+			auto newObject = dvModuleOutputAllocate(moduleData, Converter::OUTPUT_NAME);
+			auto newFrame  = static_cast<typename Converter::Output *>(newObject->obj);
 
-			break;
-		}
+			Aedat4Convert::FrameStatistics statistics;
 
-		case FRAME_EVENT: {
-			const libcaer::events::FrameEventPacket oldPacketFrame(const_cast<caerEventPacketHeader>(oldPacket), false);
+			if (Converter::convert(oldPacket, i, *newFrame, options.framePool, options.demosaic,
+					(options.frameStatistics) ? (&statistics) : (nullptr))) {
+				auto timestamp = Converter::newestTimestamp(*newFrame);
 
-			for (const auto &evt : oldPacketFrame) {
-				if (!evt.isValid()) {
-					continue;
-				}
-
-				auto newObject = dvModuleOutputAllocate(moduleData, "frames");
-				auto newFrame  = static_cast<dv::Frame *>(newObject->obj);
-
-				newFrame->timestamp                = evt.getTimestamp64(oldPacketFrame);
-				newFrame->timestampStartOfFrame    = evt.getTSStartOfFrame64(oldPacketFrame);
-				newFrame->timestampStartOfExposure = evt.getTSStartOfExposure64(oldPacketFrame);
-				newFrame->timestampEndOfExposure   = evt.getTSEndOfExposure64(oldPacketFrame);
-				newFrame->timestampEndOfFrame      = evt.getTSEndOfFrame64(oldPacketFrame);
-
-				newFrame->sizeX     = static_cast<int16_t>(evt.getLengthX());
-				newFrame->sizeY     = static_cast<int16_t>(evt.getLengthY());
-				newFrame->positionX = static_cast<int16_t>(evt.getPositionX());
-				newFrame->positionY = static_cast<int16_t>(evt.getPositionY());
-
-				// New frame format specification.
-				if (evt.getChannelNumber() == libcaer::events::FrameEvent::colorChannels::RGB) {
-					// RGB to BGR.
-					newFrame->format = dv::FrameFormat::BGR;
-				}
-				else if (evt.getChannelNumber() == libcaer::events::FrameEvent::colorChannels::RGBA) {
-					// RGBA to BGRA.
-					newFrame->format = dv::FrameFormat::BGRA;
-				}
-				else {
-					// Default: grayscale.
-					newFrame->format = dv::FrameFormat::GRAY;
-				}
-
-				newFrame->pixels.resize(evt.getPixelsMaxIndex());
-
-				for (size_t px = 0; px < evt.getPixelsMaxIndex();) {
-					switch (newFrame->format) {
-						case dv::FrameFormat::GRAY:
-							newFrame->pixels[px] = static_cast<uint8_t>(evt.getPixelArrayUnsafe()[px] >> 8);
-							px += 1;
-							break;
-
-						case dv::FrameFormat::BGR:
-							newFrame->pixels[px + 0] = static_cast<uint8_t>(evt.getPixelArrayUnsafe()[px + 2] >> 8);
-							newFrame->pixels[px + 1] = static_cast<uint8_t>(evt.getPixelArrayUnsafe()[px + 1] >> 8);
-							newFrame->pixels[px + 2] = static_cast<uint8_t>(evt.getPixelArrayUnsafe()[px + 0] >> 8);
-							px += 3;
-							break;
-
-						case dv::FrameFormat::BGRA:
-							newFrame->pixels[px + 0] = static_cast<uint8_t>(evt.getPixelArrayUnsafe()[px + 2] >> 8);
-							newFrame->pixels[px + 1] = static_cast<uint8_t>(evt.getPixelArrayUnsafe()[px + 1] >> 8);
-							newFrame->pixels[px + 2] = static_cast<uint8_t>(evt.getPixelArrayUnsafe()[px + 0] >> 8);
-							newFrame->pixels[px + 3] = static_cast<uint8_t>(evt.getPixelArrayUnsafe()[px + 3] >> 8);
-							px += 4;
-							break;
-					}
-				}
+				commitTimed(moduleData, Converter::OUTPUT_NAME, timestamp, timings);
 
-				if (newFrame->pixels.size() > 0) {
-					dvModuleOutputCommit(moduleData, "frames");
+				if (options.frameStatistics) {
+					options.frameStatistics(timestamp, statistics);
 				}
 			}
-
-			break;
 		}
+	}
+	else {
+		auto newObject = dvModuleOutputAllocate(moduleData, Converter::OUTPUT_NAME);
+		auto newPacket = static_cast<typename Converter::Output *>(newObject->obj);
 
-		case IMU6_EVENT: {
-			auto newObject    = dvModuleOutputAllocate(moduleData, "imu");
-			auto newIMUPacket = static_cast<dv::IMUPacket *>(newObject->obj);
-
-			const libcaer::events::IMU6EventPacket oldPacketIMU(const_cast<caerEventPacketHeader>(oldPacket), false);
-
-			newIMUPacket->elements.reserve(static_cast<size_t>(oldPacketIMU.getEventValid()));
-
-			for (const auto &evt : oldPacketIMU) {
-				if (!evt.isValid()) {
-					continue;
-				}
-
-				dv::IMU imu{};
-				imu.timestamp      = evt.getTimestamp64(oldPacketIMU);
-				imu.temperature    = evt.getTemp();
-				imu.accelerometerX = evt.getAccelX();
-				imu.accelerometerY = evt.getAccelY();
-				imu.accelerometerZ = evt.getAccelZ();
-				imu.gyroscopeX     = evt.getGyroX();
-				imu.gyroscopeY     = evt.getGyroY();
-				imu.gyroscopeZ     = evt.getGyroZ();
-
-				newIMUPacket->elements.push_back(imu);
-			}
-
-			if (newIMUPacket->elements.size() > 0) {
-				dvModuleOutputCommit(moduleData, "imu");
-			}
+		// IMU samples as structure of arrays, if wanted.
+		std::shared_ptr<Aedat4Convert::IMUArrays> arrays;
 
-			break;
+		if constexpr (EventType == POLARITY_EVENT) {
+			Converter::convert(oldPacket, *newPacket, begin, end, options.eventROI);
 		}
+		else if constexpr (EventType == SPECIAL_EVENT) {
+			Converter::convert(oldPacket, *newPacket, begin, end, options.triggerFilter);
+		}
+		else if (options.imuArrays) {
+			// Both layouts from the same pass over the packet.
+			arrays = std::make_shared<Aedat4Convert::IMUArrays>();
 
-		case SPECIAL_EVENT: {
-			auto newObject        = dvModuleOutputAllocate(moduleData, "triggers");
-			auto newTriggerPacket = static_cast<dv::TriggerPacket *>(newObject->obj);
-
-			const libcaer::events::SpecialEventPacket oldPacketSpecial(
-				const_cast<caerEventPacketHeader>(oldPacket), false);
+			Converter::convert(oldPacket, *newPacket, *arrays, begin, end);
+		}
+		else {
+			Converter::convert(oldPacket, *newPacket, begin, end);
+		}
 
-			newTriggerPacket->elements.reserve(static_cast<size_t>(oldPacketSpecial.getEventValid()));
+		if (newPacket->elements.size() > 0) {
+			commitTimed(moduleData, Converter::OUTPUT_NAME, Converter::newestTimestamp(*newPacket), timings);
+		}
 
-			for (const auto &evt : oldPacketSpecial) {
-				if (!evt.isValid()) {
-					continue;
-				}
+		if (arrays && (arrays->size() > 0)) {
+			options.imuArrays(std::move(arrays));
+		}
+	}
+}
 
-				dv::Trigger trigger{};
+void dvConvertToAedat4Range(caerEventPacketHeaderConst oldPacket, int32_t begin, int32_t end, dvModuleData moduleData,
+	struct dvConvertTimings *timings, const struct dvConvertOptions &options) {
+	if (oldPacket == nullptr || moduleData == nullptr) {
+		return;
+	}
 
-				if (evt.getType() == TIMESTAMP_RESET) {
-					trigger.type = dv::TriggerType::TIMESTAMP_RESET;
-				}
-				else if (evt.getType() == EXTERNAL_INPUT_RISING_EDGE) {
-					trigger.type = dv::TriggerType::EXTERNAL_SIGNAL_RISING_EDGE;
-				}
-				else if (evt.getType() == EXTERNAL_INPUT_FALLING_EDGE) {
-					trigger.type = dv::TriggerType::EXTERNAL_SIGNAL_FALLING_EDGE;
-				}
-				else if (evt.getType() == EXTERNAL_INPUT_PULSE) {
-					trigger.type = dv::TriggerType::EXTERNAL_SIGNAL_PULSE;
-				}
-				else if (evt.getType() == EXTERNAL_GENERATOR_RISING_EDGE) {
-					trigger.type = dv::TriggerType::EXTERNAL_GENERATOR_RISING_EDGE;
-				}
-				else if (evt.getType() == EXTERNAL_GENERATOR_FALLING_EDGE) {
-					trigger.type = dv::TriggerType::EXTERNAL_GENERATOR_FALLING_EDGE;
-				}
-				else if (evt.getType() == APS_FRAME_START) {
-					trigger.type = dv::TriggerType::APS_FRAME_START;
-				}
-				else if (evt.getType() == APS_FRAME_END) {
-					trigger.type = dv::TriggerType::APS_FRAME_END;
-				}
-				else if (evt.getType() == APS_EXPOSURE_START) {
-					trigger.type = dv::TriggerType::APS_EXPOSURE_START;
-				}
-				else if (evt.getType() == APS_EXPOSURE_END) {
-					trigger.type = dv::TriggerType::APS_EXPOSURE_END;
-				}
-				else {
-					continue;
-				}
+	if ((caerEventPacketHeaderGetEventValid(oldPacket) <= 0)
+		|| (begin >= std::min(end, caerEventPacketHeaderGetEventNumber(oldPacket)))) {
+		// No valid events, nothing to do.
+		return;
+	}
 
-				trigger.timestamp = evt.getTimestamp64(oldPacketSpecial);
+	switch (caerEventPacketHeaderGetEventType(oldPacket)) {
+		case POLARITY_EVENT:
+			convertToOutput<POLARITY_EVENT>(oldPacket, begin, end, moduleData, timings, options);
+			break;
 
-				newTriggerPacket->elements.push_back(trigger);
-			}
+		case FRAME_EVENT:
+			convertToOutput<FRAME_EVENT>(oldPacket, begin, end, moduleData, timings, options);
+			break;
 
-			if (newTriggerPacket->elements.size() > 0) {
-				dvModuleOutputCommit(moduleData, "triggers");
-			}
+		case IMU6_EVENT:
+			convertToOutput<IMU6_EVENT>(oldPacket, begin, end, moduleData, timings, options);
+			break;
 
+		case SPECIAL_EVENT:
+			convertToOutput<SPECIAL_EVENT>(oldPacket, begin, end, moduleData, timings, options);
 			break;
-		}
 
 		default:
 			// Unknown data.
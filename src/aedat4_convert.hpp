@@ -12,8 +12,62 @@ extern "C" {
 
 void dvConvertToAedat4(caerEventPacketHeaderConst oldPacket, dvModuleData moduleData);
 
+/**
+ * Host-clock stamps taken during a conversion, in µs of a monotonic clock.
+ * 'converted' is taken when the output data is ready, 'committed' after
+ * dvModuleOutputCommit() returned. Both stay zero if nothing was committed.
+ * 'newestTimestamp' is the device timestamp of the newest committed element.
+ */
+struct dvConvertTimings {
+	int64_t converted;
+	int64_t committed;
+	int64_t newestTimestamp;
+};
+
+void dvConvertToAedat4Timed(
+	caerEventPacketHeaderConst oldPacket, dvModuleData moduleData, struct dvConvertTimings *timings);
+
+int64_t dvConvertHostClock(void);
+
 #ifdef __cplusplus
 }
+
+#	include <functional>
+#	include <memory>
+
+class ThreadPool;
+
+namespace Aedat4Convert {
+struct EventROI;
+struct FrameStatistics;
+struct IMUArrays;
+}
+
+/**
+ * Conversion settings for dvConvertToAedat4Range(), defaults convert as
+ * dvConvertToAedat4() does.
+ */
+struct dvConvertOptions {
+	// Special events only become triggers if their type is in this set of Aedat4Convert::triggerBit().
+	uint32_t triggerFilter{UINT32_MAX};
+	// Workers sharing the rows of large frames with the calling thread, nullptr for none.
+	ThreadPool *framePool{nullptr};
+	// Region of interest and downsampling of polarity events, nullptr for the full sensor.
+	const Aedat4Convert::EventROI *eventROI{nullptr};
+	// Convert raw Bayer frames (color sensors, FrameMode Original) to BGR.
+	bool demosaic{false};
+	// If set, called with the statistics of each frame after it was committed.
+	std::function<void(int64_t timestamp, const Aedat4Convert::FrameStatistics &statistics)> frameStatistics;
+	// If set, called with the IMU samples of each conversion as structure of arrays, after they were committed.
+	std::function<void(std::shared_ptr<const Aedat4Convert::IMUArrays> arrays)> imuArrays;
+};
+
+/**
+ * Like dvConvertToAedat4Timed(), but only for the events with index in
+ * [begin, end), e.g. to convert a packet split at a timestamp reset.
+ */
+void dvConvertToAedat4Range(caerEventPacketHeaderConst oldPacket, int32_t begin, int32_t end, dvModuleData moduleData,
+	struct dvConvertTimings *timings, const struct dvConvertOptions &options = dvConvertOptions{});
 #endif
 
 #endif // AEDAT4_CONVERT_H
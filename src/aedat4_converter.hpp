@@ -0,0 +1,993 @@
+#ifndef AEDAT4_CONVERTER_HPP
+#define AEDAT4_CONVERTER_HPP
+
+#include "dv-sdk/data/event.hpp"
+#include "dv-sdk/data/frame.hpp"
+#include "dv-sdk/data/imu.hpp"
+#include "dv-sdk/data/trigger.hpp"
+
+#include "simd_dispatch.hpp"
+#include "thread_pool.hpp"
+
+#include <libcaer/events/imu6.h>
+#include <libcaer/events/polarity.h>
+#include <libcaer/events/special.h>
+#include <libcaercpp/events/frame.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+/**
+ * libcaer to AEDAT4 conversion, selected at compile time by event type and
+ * writing into caller-provided AEDAT4 objects. No module outputs involved, so
+ * usable from other modules, offline tools and benchmarks alike.
+ *
+ * Converter<TYPE> defines Output (the AEDAT4 type filled), OUTPUT_NAME (the
+ * module output it normally goes to) and convert(). Packet conversions append
+ * the valid events with index in [begin, end). Frames convert one frame at
+ * 'index' into a dv::Frame, returning false if it is invalid or empty.
+ */
+namespace Aedat4Convert {
+
+template<int16_t EventType>
+struct Converter;
+
+/**
+ * Bit of 'type' in a trigger filter, the set of trigger types to convert.
+ */
+static constexpr uint32_t triggerBit(dv::TriggerType type) {
+	return (UINT32_C(1) << static_cast<int>(type));
+}
+
+static constexpr uint32_t ALL_TRIGGERS = UINT32_MAX;
+
+/**
+ * Luminance statistics of a converted frame, counted while narrowing it: the
+ * 8 bit sensor samples for grayscale and raw Bayer frames, (R + 2G + B) / 4
+ * for color frames.
+ */
+struct FrameStatistics {
+	static constexpr size_t BINS = 256;
+
+	std::array<uint32_t, BINS> histogram{};
+
+	void clear() {
+		histogram.fill(0);
+	}
+
+	/**
+	 * Count an already converted frame, as its conversion would have: the gray
+	 * values, or (B + 2G + R) / 4 for BGR(A).
+	 */
+	void add(const dv::Frame &frame) {
+		size_t channels = (frame.format == dv::FrameFormat::BGRA)  ? (4)
+						  : (frame.format == dv::FrameFormat::BGR) ? (3)
+																   : (1);
+
+		const uint8_t *pixels = frame.pixels.data();
+
+		for (size_t px = 0; (px + channels) <= frame.pixels.size(); px += channels) {
+			if (channels == 1) {
+				histogram[pixels[px]]++;
+			}
+			else {
+				histogram[(pixels[px + 0] + (2 * pixels[px + 1]) + pixels[px + 2]) >> 2]++;
+			}
+		}
+	}
+
+	uint64_t samples() const {
+		uint64_t samples = 0;
+
+		for (auto count : histogram) {
+			samples += count;
+		}
+
+		return (samples);
+	}
+
+	// Mean 8 bit value, 0 if empty.
+	double mean() const {
+		uint64_t sum = 0;
+
+		for (size_t i = 0; i < BINS; i++) {
+			sum += i * histogram[i];
+		}
+
+		auto total = samples();
+
+		return ((total > 0) ? (static_cast<double>(sum) / static_cast<double>(total)) : (0));
+	}
+
+	// Fraction of samples at 0 (under-exposed).
+	double clippedDark() const {
+		return (fraction(histogram[0]));
+	}
+
+	// Fraction of samples at 255 (over-exposed).
+	double clippedBright() const {
+		return (fraction(histogram[BINS - 1]));
+	}
+
+private:
+	double fraction(uint32_t count) const {
+		auto total = samples();
+
+		return ((total > 0) ? (static_cast<double>(count) / static_cast<double>(total)) : (0));
+	}
+};
+
+/**
+ * Software region of interest for polarity events. Only events inside
+ * [startX, startX + sizeX) x [startY, startY + sizeY) are converted, with
+ * coordinates relative to the start and divided by 2^shift, merging blocks of
+ * pixels to downsample.
+ */
+struct EventROI {
+	int16_t startX{0};
+	int16_t startY{0};
+	int16_t sizeX{INT16_MAX};
+	int16_t sizeY{INT16_MAX};
+	uint8_t shift{0};
+
+	int16_t outputSizeX() const {
+		return (static_cast<int16_t>((sizeX + (1 << shift) - 1) >> shift));
+	}
+
+	int16_t outputSizeY() const {
+		return (static_cast<int16_t>((sizeY + (1 << shift) - 1) >> shift));
+	}
+
+	// 1 if inside, 0 if not; negative offsets wrap around to large unsigned ones.
+	uint32_t contains(uint32_t x, uint32_t y) const {
+		return (static_cast<uint32_t>((x - static_cast<uint32_t>(startX)) < static_cast<uint32_t>(sizeX))
+				& static_cast<uint32_t>((y - static_cast<uint32_t>(startY)) < static_cast<uint32_t>(sizeY)));
+	}
+
+	int16_t mapX(uint32_t x) const {
+		return (static_cast<int16_t>((x - static_cast<uint32_t>(startX)) >> shift));
+	}
+
+	int16_t mapY(uint32_t y) const {
+		return (static_cast<int16_t>((y - static_cast<uint32_t>(startY)) >> shift));
+	}
+};
+
+/**
+ * Allocator leaving new elements default-initialized, i.e. not zeroed for
+ * arithmetic types, for arrays that are grown and then written right away.
+ */
+template<typename T>
+struct DefaultInitAllocator : std::allocator<T> {
+	template<typename U>
+	struct rebind {
+		using other = DefaultInitAllocator<U>;
+	};
+
+	using std::allocator<T>::allocator;
+
+	template<typename U>
+	void construct(U *ptr) noexcept(std::is_nothrow_default_constructible_v<U>) {
+		::new (static_cast<void *>(ptr)) U;
+	}
+
+	template<typename U, typename... Args>
+	void construct(U *ptr, Args &&...args) {
+		::new (static_cast<void *>(ptr)) U(std::forward<Args>(args)...);
+	}
+};
+
+/**
+ * IMU samples as structure of arrays, one contiguous array per field, for
+ * consumers processing many samples at once with SIMD. Index i across all
+ * arrays is one sample, same units as dv::IMU. The davis module publishes them
+ * on the Passthrough<IMUArrays> channel named in imuArrays/Channel. Growing
+ * them leaves the new samples uninitialized, they're always written next.
+ */
+struct IMUArrays {
+	template<typename T>
+	using Array = std::vector<T, DefaultInitAllocator<T>>;
+
+	Array<int64_t> timestamp;
+	Array<float> temperature;
+	Array<float> accelerometerX;
+	Array<float> accelerometerY;
+	Array<float> accelerometerZ;
+	Array<float> gyroscopeX;
+	Array<float> gyroscopeY;
+	Array<float> gyroscopeZ;
+
+	size_t size() const {
+		return (timestamp.size());
+	}
+
+	void resize(size_t size) {
+		timestamp.resize(size);
+		temperature.resize(size);
+		accelerometerX.resize(size);
+		accelerometerY.resize(size);
+		accelerometerZ.resize(size);
+		gyroscopeX.resize(size);
+		gyroscopeY.resize(size);
+		gyroscopeZ.resize(size);
+	}
+
+	void clear() {
+		resize(0);
+	}
+};
+
+namespace detail {
+
+static inline int32_t rangeEnd(caerEventPacketHeaderConst packet, int32_t end) {
+	return (std::min(end, caerEventPacketHeaderGetEventNumber(packet)));
+}
+
+static inline int countTrailingZeros(uint64_t value) {
+#if defined(__GNUC__)
+	return (__builtin_ctzll(value));
+#else
+	int count = 0;
+
+	while ((value & 0x01) == 0) {
+		value >>= 1;
+		count++;
+	}
+
+	return (count);
+#endif
+}
+
+// Keep predicate for compact(): the validity mark, bit 0 of the first word of all libcaer events.
+template<typename In>
+static SIMD_ALWAYS_INLINE uint32_t validMark(const In &evt) {
+	uint32_t first;
+	memcpy(&first, &evt, sizeof(uint32_t));
+
+	return (first & VALID_MARK_MASK);
+}
+
+/**
+ * Stream compaction without a branch per event: 'keep' (returning 0 or 1) is
+ * evaluated for a block of 64 events into a mask first, a loop the compiler
+ * vectorizes. Full blocks are stored straight through, empty ones skipped,
+ * and mixed ones store only the survivors, walking the set bits of the mask.
+ * Heavily filtered packets so cost little more than scanning their validity
+ * bits. 'store(index, event)' writes a kept event at output 'index'. Returns
+ * the number of events stored.
+ */
+template<typename In, typename Keep, typename Store>
+static SIMD_ALWAYS_INLINE size_t compactStore(const In *in, size_t count, Keep keep, Store store) {
+	size_t written = 0;
+
+	for (size_t block = 0; block < count; block += 64) {
+		const In *blockIn = in + block;
+		size_t blockSize  = std::min<size_t>(64, count - block);
+
+		uint64_t mask = 0;
+
+		for (size_t i = 0; i < blockSize; i++) {
+			mask |= static_cast<uint64_t>(keep(blockIn[i])) << i;
+		}
+
+		uint64_t full = (blockSize == 64) ? (UINT64_MAX) : ((UINT64_C(1) << blockSize) - 1);
+
+		if (mask == full) {
+			for (size_t i = 0; i < blockSize; i++) {
+				store(written + i, blockIn[i]);
+			}
+
+			written += blockSize;
+		}
+		else {
+			while (mask != 0) {
+				store(written++, blockIn[countTrailingZeros(mask)]);
+				mask &= (mask - 1);
+			}
+		}
+	}
+
+	return (written);
+}
+
+// compactStore() into an array, 'decode(event)' giving the output element.
+template<typename In, typename Out, typename Keep, typename Decode>
+static SIMD_ALWAYS_INLINE size_t compact(const In *in, size_t count, Out *out, Keep keep, Decode decode) {
+	return (compactStore(in, count, keep, [out, &decode](size_t index, const In &evt) {
+		out[index] = decode(evt);
+	}));
+}
+
+// Raw polarity events to dv::Event, skipping invalid ones. Returns the number written.
+static SIMD_ALWAYS_INLINE size_t decodePolarityBody(
+	const struct caer_polarity_event *in, size_t count, int64_t tsOverflow, dv::Event *out) {
+	auto decode = [tsOverflow](const struct caer_polarity_event &evt) {
+		// Little-endian, like the host on all supported platforms.
+		return (dv::Event(tsOverflow | evt.timestamp,
+			static_cast<int16_t>((evt.data >> POLARITY_X_ADDR_SHIFT) & POLARITY_X_ADDR_MASK),
+			static_cast<int16_t>((evt.data >> POLARITY_Y_ADDR_SHIFT) & POLARITY_Y_ADDR_MASK),
+			static_cast<bool>((evt.data >> POLARITY_SHIFT) & POLARITY_MASK)));
+	};
+
+	return (compact(in, count, out, validMark<struct caer_polarity_event>, decode));
+}
+
+SIMD_KERNEL(size_t, decodePolarity,
+	(const struct caer_polarity_event *in, size_t count, int64_t tsOverflow, dv::Event *out),
+	(in, count, tsOverflow, out), const struct caer_polarity_event *, size_t, int64_t, dv::Event *);
+
+// Same, only keeping events inside 'roi', with mapped coordinates. Events outside are never materialized.
+static SIMD_ALWAYS_INLINE size_t decodePolarityROIBody(
+	const struct caer_polarity_event *in, size_t count, int64_t tsOverflow, EventROI roi, dv::Event *out) {
+	auto keep = [roi](const struct caer_polarity_event &evt) {
+		return (validMark(evt)
+				& roi.contains((evt.data >> POLARITY_X_ADDR_SHIFT) & POLARITY_X_ADDR_MASK,
+					(evt.data >> POLARITY_Y_ADDR_SHIFT) & POLARITY_Y_ADDR_MASK));
+	};
+
+	auto decode = [tsOverflow, roi](const struct caer_polarity_event &evt) {
+		return (dv::Event(tsOverflow | evt.timestamp,
+			roi.mapX((evt.data >> POLARITY_X_ADDR_SHIFT) & POLARITY_X_ADDR_MASK),
+			roi.mapY((evt.data >> POLARITY_Y_ADDR_SHIFT) & POLARITY_Y_ADDR_MASK),
+			static_cast<bool>((evt.data >> POLARITY_SHIFT) & POLARITY_MASK)));
+	};
+
+	return (compact(in, count, out, keep, decode));
+}
+
+SIMD_KERNEL(size_t, decodePolarityROI,
+	(const struct caer_polarity_event *in, size_t count, int64_t tsOverflow, EventROI roi, dv::Event *out),
+	(in, count, tsOverflow, roi, out), const struct caer_polarity_event *, size_t, int64_t, EventROI, dv::Event *);
+
+static SIMD_ALWAYS_INLINE dv::IMU decodeIMU6Sample(const struct caer_imu6_event &evt, int64_t tsOverflow) {
+	dv::IMU imu{};
+	imu.timestamp      = tsOverflow | evt.timestamp;
+	imu.temperature    = evt.temp;
+	imu.accelerometerX = evt.accel_x;
+	imu.accelerometerY = evt.accel_y;
+	imu.accelerometerZ = evt.accel_z;
+	imu.gyroscopeX     = evt.gyro_x;
+	imu.gyroscopeY     = evt.gyro_y;
+	imu.gyroscopeZ     = evt.gyro_z;
+
+	return (imu);
+}
+
+// Raw IMU6 samples to dv::IMU, skipping invalid ones. Returns the number written.
+static SIMD_ALWAYS_INLINE size_t decodeIMU6Body(
+	const struct caer_imu6_event *in, size_t count, int64_t tsOverflow, dv::IMU *out) {
+	auto decode = [tsOverflow](const struct caer_imu6_event &evt) {
+		return (decodeIMU6Sample(evt, tsOverflow));
+	};
+
+	return (compact(in, count, out, validMark<struct caer_imu6_event>, decode));
+}
+
+SIMD_KERNEL(size_t, decodeIMU6, (const struct caer_imu6_event *in, size_t count, int64_t tsOverflow, dv::IMU *out),
+	(in, count, tsOverflow, out), const struct caer_imu6_event *, size_t, int64_t, dv::IMU *);
+
+// Same, in the same pass also into IMUArrays, from index 'offset' on.
+static SIMD_ALWAYS_INLINE size_t decodeIMU6ArraysBody(const struct caer_imu6_event *in, size_t count,
+	int64_t tsOverflow, dv::IMU *out, IMUArrays *arrays, size_t offset) {
+	auto timestamp      = arrays->timestamp.data() + offset;
+	auto temperature    = arrays->temperature.data() + offset;
+	auto accelerometerX = arrays->accelerometerX.data() + offset;
+	auto accelerometerY = arrays->accelerometerY.data() + offset;
+	auto accelerometerZ = arrays->accelerometerZ.data() + offset;
+	auto gyroscopeX     = arrays->gyroscopeX.data() + offset;
+	auto gyroscopeY     = arrays->gyroscopeY.data() + offset;
+	auto gyroscopeZ     = arrays->gyroscopeZ.data() + offset;
+
+	auto store = [&](size_t index, const struct caer_imu6_event &evt) {
+		auto imu = decodeIMU6Sample(evt, tsOverflow);
+
+		out[index]            = imu;
+		timestamp[index]      = imu.timestamp;
+		temperature[index]    = imu.temperature;
+		accelerometerX[index] = imu.accelerometerX;
+		accelerometerY[index] = imu.accelerometerY;
+		accelerometerZ[index] = imu.accelerometerZ;
+		gyroscopeX[index]     = imu.gyroscopeX;
+		gyroscopeY[index]     = imu.gyroscopeY;
+		gyroscopeZ[index]     = imu.gyroscopeZ;
+	};
+
+	return (compactStore(in, count, validMark<struct caer_imu6_event>, store));
+}
+
+SIMD_KERNEL(size_t, decodeIMU6Arrays,
+	(const struct caer_imu6_event *in, size_t count, int64_t tsOverflow, dv::IMU *out, IMUArrays *arrays,
+		size_t offset),
+	(in, count, tsOverflow, out, arrays, offset), const struct caer_imu6_event *, size_t, int64_t, dv::IMU *,
+	IMUArrays *, size_t);
+
+struct TriggerMapping {
+	uint32_t bit; // Bit of the trigger type in a trigger filter, 0 if not a trigger.
+	dv::TriggerType type;
+};
+
+// libcaer special event type (7 bits) to trigger type, for decoding without a branch per type.
+static constexpr auto TRIGGER_TABLE = [] {
+	std::array<TriggerMapping, SPECIAL_TYPE_MASK + 1> table{};
+
+	auto map = [&table](uint8_t specialType, dv::TriggerType type) {
+		table[specialType] = {triggerBit(type), type};
+	};
+
+	map(TIMESTAMP_RESET, dv::TriggerType::TIMESTAMP_RESET);
+	map(EXTERNAL_INPUT_RISING_EDGE, dv::TriggerType::EXTERNAL_SIGNAL_RISING_EDGE);
+	map(EXTERNAL_INPUT_FALLING_EDGE, dv::TriggerType::EXTERNAL_SIGNAL_FALLING_EDGE);
+	map(EXTERNAL_INPUT_PULSE, dv::TriggerType::EXTERNAL_SIGNAL_PULSE);
+	map(EXTERNAL_GENERATOR_RISING_EDGE, dv::TriggerType::EXTERNAL_GENERATOR_RISING_EDGE);
+	map(EXTERNAL_GENERATOR_FALLING_EDGE, dv::TriggerType::EXTERNAL_GENERATOR_FALLING_EDGE);
+	map(APS_FRAME_START, dv::TriggerType::APS_FRAME_START);
+	map(APS_FRAME_END, dv::TriggerType::APS_FRAME_END);
+	map(APS_EXPOSURE_START, dv::TriggerType::APS_EXPOSURE_START);
+	map(APS_EXPOSURE_END, dv::TriggerType::APS_EXPOSURE_END);
+
+	return (table);
+}();
+
+static SIMD_ALWAYS_INLINE const TriggerMapping &triggerMapping(const struct caer_special_event &evt) {
+	return (TRIGGER_TABLE[(evt.data >> SPECIAL_TYPE_SHIFT) & SPECIAL_TYPE_MASK]);
+}
+
+// Raw special events to dv::Trigger, keeping the valid ones whose trigger type is in 'filter'.
+static SIMD_ALWAYS_INLINE size_t decodeSpecialBody(
+	const struct caer_special_event *in, size_t count, int64_t tsOverflow, uint32_t filter, dv::Trigger *out) {
+	auto keep = [filter](const struct caer_special_event &evt) {
+		return (validMark(evt) & static_cast<uint32_t>((triggerMapping(evt).bit & filter) != 0));
+	};
+
+	auto decode = [tsOverflow](const struct caer_special_event &evt) {
+		dv::Trigger trigger{};
+		trigger.timestamp = tsOverflow | evt.timestamp;
+		trigger.type      = triggerMapping(evt).type;
+
+		return (trigger);
+	};
+
+	return (compact(in, count, out, keep, decode));
+}
+
+SIMD_KERNEL(size_t, decodeSpecial,
+	(const struct caer_special_event *in, size_t count, int64_t tsOverflow, uint32_t filter, dv::Trigger *out),
+	(in, count, tsOverflow, filter, out), const struct caer_special_event *, size_t, int64_t, uint32_t,
+	dv::Trigger *);
+
+static inline int64_t timestampOverflow(caerEventPacketHeaderConst packet) {
+	return (static_cast<int64_t>(
+		static_cast<uint64_t>(caerEventPacketHeaderGetEventTSOverflow(packet)) << TS_OVERFLOW_SHIFT));
+}
+
+// Events per appendDecoded() chunk, its decoded elements stay in L1.
+static constexpr size_t DECODE_CHUNK = 512;
+
+/**
+ * Decode events [begin, end) of a packet with 'kernel', appending the valid
+ * ones to the output vector. dv::cvector value-initializes everything on
+ * resize(), a whole extra write pass over the output: the kernel writes into
+ * uninitialized chunk storage instead, and only the kept elements are copied
+ * out, into space reserved up front.
+ */
+template<typename InEvent, typename Elements, typename Kernel>
+static inline void appendDecoded(
+	caerEventPacketHeaderConst packet, int32_t begin, int32_t end, Elements &elements, const Kernel &kernel) {
+	using Element = typename Elements::value_type;
+
+	static_assert(std::is_trivially_copyable_v<Element>, "Decoded elements are stored without construction");
+
+	end = rangeEnd(packet, end);
+
+	if (begin >= end) {
+		return;
+	}
+
+	auto events     = reinterpret_cast<const InEvent *>(caerGenericEventGetEvent(packet, begin));
+	auto count      = static_cast<size_t>(end - begin);
+	auto tsOverflow = timestampOverflow(packet);
+
+	elements.reserve(elements.size() + count);
+
+	alignas(Element) unsigned char storage[DECODE_CHUNK * sizeof(Element)];
+	auto chunk = reinterpret_cast<Element *>(storage);
+
+	for (size_t first = 0; first < count; first += DECODE_CHUNK) {
+		auto written = kernel(events + first, std::min(DECODE_CHUNK, count - first), tsOverflow, chunk);
+
+		elements.insert(elements.end(), chunk, chunk + written);
+	}
+}
+
+// 16 bit to 8 bit pixels, grayscale. With a 'histogram' (256 bins), also counts the 8 bit values.
+static SIMD_ALWAYS_INLINE void narrowPixelsBody(const uint16_t *in, uint8_t *out, size_t count, uint32_t *histogram) {
+	if (histogram == nullptr) {
+		for (size_t i = 0; i < count; i++) {
+			out[i] = static_cast<uint8_t>(in[i] >> 8);
+		}
+
+		return;
+	}
+
+	for (size_t i = 0; i < count; i++) {
+		auto value = static_cast<uint8_t>(in[i] >> 8);
+
+		out[i] = value;
+		histogram[value]++;
+	}
+}
+
+SIMD_KERNEL(void, narrowPixels, (const uint16_t *in, uint8_t *out, size_t count, uint32_t *histogram),
+	(in, out, count, histogram), const uint16_t *, uint8_t *, size_t, uint32_t *);
+
+// 16 bit to 8 bit pixels, RGB(A) to BGR(A). With a 'histogram', also counts the luma (R + 2G + B) / 4.
+static SIMD_ALWAYS_INLINE void narrowSwapPixelsBody(
+	const uint16_t *in, uint8_t *out, size_t count, size_t channels, uint32_t *histogram) {
+	for (size_t px = 0; px < count; px += channels) {
+		out[px + 0] = static_cast<uint8_t>(in[px + 2] >> 8);
+		out[px + 1] = static_cast<uint8_t>(in[px + 1] >> 8);
+		out[px + 2] = static_cast<uint8_t>(in[px + 0] >> 8);
+
+		if (channels == 4) {
+			out[px + 3] = static_cast<uint8_t>(in[px + 3] >> 8);
+		}
+
+		if (histogram != nullptr) {
+			histogram[(out[px + 0] + (2 * out[px + 1]) + out[px + 2]) >> 2]++;
+		}
+	}
+}
+
+SIMD_KERNEL(void, narrowSwapPixels,
+	(const uint16_t *in, uint8_t *out, size_t count, size_t channels, uint32_t *histogram),
+	(in, out, count, channels, histogram), const uint16_t *, uint8_t *, size_t, size_t, uint32_t *);
+
+enum BayerColor : uint8_t {
+	BAYER_RED   = 0,
+	BAYER_GREEN = 1,
+	BAYER_BLUE  = 2,
+};
+
+/**
+ * Color of each site of the 2x2 Bayer cell, indexed by ((y & 1) << 1) | (x & 1)
+ * in frame coordinates. libcaer names patterns clockwise from the top-left
+ * pixel (RGBG is R G / G B), and ROI frames starting on an odd row or column
+ * see the pattern shifted. Returns false if not a Bayer pattern.
+ */
+static inline bool bayerSites(int colorFilter, int32_t positionX, int32_t positionY, std::array<uint8_t, 4> &sites) {
+	std::array<uint8_t, 4> clockwise{};
+
+	switch (colorFilter) {
+		case RGBG:
+			clockwise = {BAYER_RED, BAYER_GREEN, BAYER_BLUE, BAYER_GREEN};
+			break;
+		case GRGB:
+			clockwise = {BAYER_GREEN, BAYER_RED, BAYER_GREEN, BAYER_BLUE};
+			break;
+		case GBGR:
+			clockwise = {BAYER_GREEN, BAYER_BLUE, BAYER_GREEN, BAYER_RED};
+			break;
+		case BGRG:
+			clockwise = {BAYER_BLUE, BAYER_GREEN, BAYER_RED, BAYER_GREEN};
+			break;
+		default:
+			// Monochrome, or with white pixels (RGBW): no bilinear Bayer interpolation.
+			return (false);
+	}
+
+	// Clockwise order to (y, x) index: top-left, top-right, bottom-right, bottom-left.
+	const std::array<uint8_t, 4> cell{clockwise[0], clockwise[1], clockwise[3], clockwise[2]};
+
+	for (size_t i = 0; i < 4; i++) {
+		size_t x = ((i & 0x01) + static_cast<size_t>(positionX)) & 0x01;
+		size_t y = ((i >> 1) + static_cast<size_t>(positionY)) & 0x01;
+
+		sites[i] = cell[(y << 1) | x];
+	}
+
+	return (true);
+}
+
+// Pixels per demosaicRows() pass, the interpolated planes of one pass stay in L1.
+static constexpr size_t DEMOSAIC_CHUNK = 512;
+
+enum DemosaicPlane : uint8_t {
+	PLANE_OWN        = 0,
+	PLANE_HORIZONTAL = 1,
+	PLANE_VERTICAL   = 2,
+	PLANE_CROSS      = 3,
+	PLANE_DIAGONAL   = 4,
+	PLANES           = 5,
+};
+
+// Which plane gives red, green and blue at a site of the given color.
+static inline void demosaicChannelPlanes(uint8_t site, bool redRow, uint8_t planes[3]) {
+	if (site == BAYER_GREEN) {
+		planes[BAYER_RED]   = (redRow) ? (PLANE_HORIZONTAL) : (PLANE_VERTICAL);
+		planes[BAYER_GREEN] = PLANE_OWN;
+		planes[BAYER_BLUE]  = (redRow) ? (PLANE_VERTICAL) : (PLANE_HORIZONTAL);
+	}
+	else {
+		planes[BAYER_RED]   = (site == BAYER_RED) ? (PLANE_OWN) : (PLANE_DIAGONAL);
+		planes[BAYER_GREEN] = PLANE_CROSS;
+		planes[BAYER_BLUE]  = (site == BAYER_RED) ? (PLANE_DIAGONAL) : (PLANE_OWN);
+	}
+}
+
+/**
+ * Bilinear Bayer to BGR of rows [firstRow, lastRow), reading 16 bit samples and
+ * writing 8 bit ones. A site's own color is narrowed exactly like
+ * narrowPixels() does, the two missing ones are the mean of the 2 or 4 nearest
+ * samples of that color, truncated and narrowed. Borders mirror, which keeps
+ * the Bayer phase. Frames must be at least 2x2. With a 'histogram', also
+ * counts the narrowed sensor samples, as for a grayscale frame.
+ *
+ * To vectorize, each chunk of a row goes through unit-stride passes: first all
+ * five interpolations (own, horizontal, vertical, cross, diagonal) for every
+ * pixel, each into its own plane, then B, G and R are picked from the planes
+ * the row's Bayer phase assigns to even and odd columns, and interleaved.
+ */
+static SIMD_ALWAYS_INLINE void demosaicRowsBody(const uint16_t *in, uint8_t *out, size_t sizeX, size_t sizeY,
+	size_t firstRow, size_t lastRow, uint32_t packedSites, uint32_t *histogram) {
+	alignas(64) uint8_t planes[PLANES][DEMOSAIC_CHUNK];
+
+	for (size_t y = firstRow; y < lastRow; y++) {
+		const uint16_t *up   = in + (((y == 0) ? (1) : (y - 1)) * sizeX);
+		const uint16_t *row  = in + (y * sizeX);
+		const uint16_t *down = in + (((y + 1 == sizeY) ? (y - 1) : (y + 1)) * sizeX);
+		uint8_t *bgr         = out + (y * sizeX * 3);
+
+		uint8_t evenSite = static_cast<uint8_t>((packedSites >> (((y & 1) << 1) * 8)) & 0xFF);
+		uint8_t oddSite  = static_cast<uint8_t>((packedSites >> ((((y & 1) << 1) | 1) * 8)) & 0xFF);
+		bool redRow      = (evenSite == BAYER_RED) || (oddSite == BAYER_RED);
+
+		uint8_t evenPlanes[3], oddPlanes[3];
+		demosaicChannelPlanes(evenSite, redRow, evenPlanes);
+		demosaicChannelPlanes(oddSite, redRow, oddPlanes);
+
+		for (size_t x0 = 0; x0 < sizeX; x0 += DEMOSAIC_CHUNK) {
+			size_t x1 = std::min(x0 + DEMOSAIC_CHUNK, sizeX);
+
+			uint8_t *own        = planes[PLANE_OWN] - x0;
+			uint8_t *horizontal = planes[PLANE_HORIZONTAL] - x0;
+			uint8_t *vertical   = planes[PLANE_VERTICAL] - x0;
+			uint8_t *cross      = planes[PLANE_CROSS] - x0;
+			uint8_t *diagonal   = planes[PLANE_DIAGONAL] - x0;
+
+			auto interpolate = [&](size_t x, size_t left, size_t right) {
+				uint32_t sideSum     = static_cast<uint32_t>(row[left]) + row[right];
+				uint32_t verticalSum = static_cast<uint32_t>(up[x]) + down[x];
+
+				own[x]        = static_cast<uint8_t>(row[x] >> 8);
+				horizontal[x] = static_cast<uint8_t>(sideSum >> 9);
+				vertical[x]   = static_cast<uint8_t>(verticalSum >> 9);
+				cross[x]      = static_cast<uint8_t>((sideSum + verticalSum) >> 10);
+				diagonal[x]   = static_cast<uint8_t>(
+					(static_cast<uint32_t>(up[left]) + up[right] + down[left] + down[right]) >> 10);
+			};
+
+			// Interior, neighbours at x - 1 and x + 1: plain unit-stride loads.
+			size_t inner0 = std::max<size_t>(x0, 1);
+			size_t inner1 = std::min(x1, sizeX - 1);
+
+			for (size_t x = inner0; x < inner1; x++) {
+				interpolate(x, x - 1, x + 1);
+			}
+
+			// Mirrored borders.
+			if (x0 == 0) {
+				interpolate(0, 1, 1);
+			}
+			if (x1 == sizeX) {
+				interpolate(sizeX - 1, sizeX - 2, sizeX - 2);
+			}
+
+			const uint8_t *evenRed   = planes[evenPlanes[BAYER_RED]] - x0;
+			const uint8_t *oddRed    = planes[oddPlanes[BAYER_RED]] - x0;
+			const uint8_t *evenGreen = planes[evenPlanes[BAYER_GREEN]] - x0;
+			const uint8_t *oddGreen  = planes[oddPlanes[BAYER_GREEN]] - x0;
+			const uint8_t *evenBlue  = planes[evenPlanes[BAYER_BLUE]] - x0;
+			const uint8_t *oddBlue   = planes[oddPlanes[BAYER_BLUE]] - x0;
+
+			// Column parity alternates per lane: a blend with a constant mask, both sides loaded.
+			for (size_t x = x0; x < x1; x++) {
+				auto odd = static_cast<uint8_t>(-static_cast<uint8_t>(x & 1));
+
+				bgr[(x * 3) + 0] = static_cast<uint8_t>((oddBlue[x] & odd) | (evenBlue[x] & ~odd));
+				bgr[(x * 3) + 1] = static_cast<uint8_t>((oddGreen[x] & odd) | (evenGreen[x] & ~odd));
+				bgr[(x * 3) + 2] = static_cast<uint8_t>((oddRed[x] & odd) | (evenRed[x] & ~odd));
+			}
+
+			if (histogram != nullptr) {
+				for (size_t x = x0; x < x1; x++) {
+					histogram[own[x]]++;
+				}
+			}
+		}
+	}
+}
+
+SIMD_KERNEL(void, demosaicRows,
+	(const uint16_t *in, uint8_t *out, size_t sizeX, size_t sizeY, size_t firstRow, size_t lastRow,
+		uint32_t packedSites, uint32_t *histogram),
+	(in, out, sizeX, sizeY, firstRow, lastRow, packedSites, histogram), const uint16_t *, uint8_t *, size_t, size_t,
+	size_t, size_t, uint32_t, uint32_t *);
+
+// Below this many samples, handing rows to other threads costs more than it saves (DAVIS346 is about 90k).
+static constexpr size_t PARALLEL_MIN_SAMPLES = 128 * 1024;
+
+/**
+ * Run 'function(firstRow, lastRow)' over all rows, in one call on the calling
+ * thread, or for large frames as contiguous row ranges spread over the pool
+ * workers and the calling thread. Returns once all rows are done.
+ */
+template<typename Function>
+static inline void forRows(ThreadPool *pool, size_t rows, size_t rowSize, const Function &function) {
+	if ((pool == nullptr) || ((rows * rowSize) < PARALLEL_MIN_SAMPLES)) {
+		function(0, rows);
+		return;
+	}
+
+	size_t chunks    = std::min(pool->size() + 1, rows);
+	size_t chunkRows = (rows + chunks - 1) / chunks;
+
+	std::vector<std::future<void>> done;
+	done.reserve(chunks);
+
+	for (size_t first = chunkRows; first < rows; first += chunkRows) {
+		auto last = std::min(first + chunkRows, rows);
+
+		// Workers run the kernels at this thread's level.
+		done.push_back(pool->submit([&function, first, last, level = Simd::active()] {
+			Simd::Scope simdScope(level);
+
+			function(first, last);
+		}));
+	}
+
+	function(0, std::min(chunkRows, rows));
+
+	for (auto &chunk : done) {
+		chunk.get();
+	}
+}
+
+/**
+ * forRows() with 'function(firstRow, lastRow, histogram)'. With 'statistics',
+ * each row range counts into its own histogram, merged at the end of the
+ * range; without, 'histogram' is nullptr.
+ */
+template<typename Function>
+static inline void forRowsCounting(
+	ThreadPool *pool, size_t rows, size_t rowSize, FrameStatistics *statistics, const Function &function) {
+	if (statistics == nullptr) {
+		forRows(pool, rows, rowSize, [&function](size_t first, size_t last) {
+			function(first, last, nullptr);
+		});
+		return;
+	}
+
+	std::mutex statisticsLock;
+
+	forRows(pool, rows, rowSize, [&function, &statisticsLock, statistics](size_t first, size_t last) {
+		std::array<uint32_t, FrameStatistics::BINS> histogram{};
+
+		function(first, last, histogram.data());
+
+		std::scoped_lock lock(statisticsLock);
+
+		for (size_t i = 0; i < FrameStatistics::BINS; i++) {
+			statistics->histogram[i] += histogram[i];
+		}
+	});
+}
+
+} // namespace detail
+
+template<>
+struct Converter<POLARITY_EVENT> {
+	using Output = dv::EventPacket;
+
+	static constexpr const char *OUTPUT_NAME = "events";
+
+	// With a 'roi', only events inside it are converted, to its coordinates.
+	static void convert(caerEventPacketHeaderConst packet, Output &out, int32_t begin = 0, int32_t end = INT32_MAX,
+		const EventROI *roi = nullptr) {
+		if (roi == nullptr) {
+			detail::appendDecoded<struct caer_polarity_event>(packet, begin, end, out.elements, detail::decodePolarity);
+			return;
+		}
+
+		detail::appendDecoded<struct caer_polarity_event>(packet, begin, end, out.elements,
+			[roi](const struct caer_polarity_event *in, size_t count, int64_t tsOverflow, dv::Event *elements) {
+				return (detail::decodePolarityROI(in, count, tsOverflow, *roi, elements));
+			});
+	}
+
+	static int64_t newestTimestamp(const Output &out) {
+		return (out.elements.back().timestamp());
+	}
+};
+
+template<>
+struct Converter<FRAME_EVENT> {
+	using Output = dv::Frame;
+
+	static constexpr const char *OUTPUT_NAME = "frames";
+
+	// With a 'pool', the rows of large frames are split across its workers and the calling thread.
+	// With 'demosaic', raw Bayer frames (color sensor, single channel) are converted to BGR.
+	// With 'statistics', these are computed for the frame in the same pass.
+	static bool convert(caerEventPacketHeaderConst packet, int32_t index, Output &out, ThreadPool *pool = nullptr,
+		bool demosaic = false, FrameStatistics *statistics = nullptr) {
+		const libcaer::events::FrameEventPacket frames(const_cast<caerEventPacketHeader>(packet), false);
+
+		const auto &evt = frames[index];
+
+		if (!evt.isValid()) {
+			return (false);
+		}
+
+		out.timestamp                = evt.getTimestamp64(frames);
+		out.timestampStartOfFrame    = evt.getTSStartOfFrame64(frames);
+		out.timestampStartOfExposure = evt.getTSStartOfExposure64(frames);
+		out.timestampEndOfExposure   = evt.getTSEndOfExposure64(frames);
+		out.timestampEndOfFrame      = evt.getTSEndOfFrame64(frames);
+
+		out.sizeX     = static_cast<int16_t>(evt.getLengthX());
+		out.sizeY     = static_cast<int16_t>(evt.getLengthY());
+		out.positionX = static_cast<int16_t>(evt.getPositionX());
+		out.positionY = static_cast<int16_t>(evt.getPositionY());
+
+		// New frame format specification.
+		if (evt.getChannelNumber() == libcaer::events::FrameEvent::colorChannels::RGB) {
+			// RGB to BGR.
+			out.format = dv::FrameFormat::BGR;
+		}
+		else if (evt.getChannelNumber() == libcaer::events::FrameEvent::colorChannels::RGBA) {
+			// RGBA to BGRA.
+			out.format = dv::FrameFormat::BGRA;
+		}
+		else {
+			// Default: grayscale.
+			out.format = dv::FrameFormat::GRAY;
+		}
+
+		if (statistics != nullptr) {
+			statistics->clear();
+		}
+
+		std::array<uint8_t, 4> sites;
+
+		if (demosaic && (out.format == dv::FrameFormat::GRAY) && (out.sizeX >= 2) && (out.sizeY >= 2)
+			&& detail::bayerSites(caerFrameEventGetColorFilter(&evt), out.positionX, out.positionY, sites)) {
+			convertBayer(evt, out, pool, sites, statistics);
+			return (out.pixels.size() > 0);
+		}
+
+		out.pixels.resize(evt.getPixelsMaxIndex());
+
+		auto in       = evt.getPixelArrayUnsafe();
+		auto pixels   = out.pixels.data();
+		auto channels = static_cast<size_t>(evt.getChannelNumber());
+		auto rowSize  = static_cast<size_t>(evt.getLengthX()) * channels;
+
+		detail::forRowsCounting(pool, static_cast<size_t>(evt.getLengthY()), rowSize, statistics,
+			[=](size_t first, size_t last, uint32_t *histogram) {
+				auto offset = first * rowSize;
+				auto count  = (last - first) * rowSize;
+
+				if (channels == 1) {
+					detail::narrowPixels(in + offset, pixels + offset, count, histogram);
+				}
+				else {
+					detail::narrowSwapPixels(in + offset, pixels + offset, count, channels, histogram);
+				}
+			});
+
+		return (out.pixels.size() > 0);
+	}
+
+	static int64_t newestTimestamp(const Output &out) {
+		return (out.timestamp);
+	}
+
+private:
+	static void convertBayer(const libcaer::events::FrameEvent &evt, Output &out, ThreadPool *pool,
+		const std::array<uint8_t, 4> &sites, FrameStatistics *statistics) {
+		out.format = dv::FrameFormat::BGR;
+		out.pixels.resize(evt.getPixelsMaxIndex() * 3);
+
+		auto in     = evt.getPixelArrayUnsafe();
+		auto pixels = out.pixels.data();
+		auto sizeX  = static_cast<size_t>(out.sizeX);
+		auto sizeY  = static_cast<size_t>(out.sizeY);
+
+		uint32_t packedSites = static_cast<uint32_t>(sites[0]) | (static_cast<uint32_t>(sites[1]) << 8)
+							   | (static_cast<uint32_t>(sites[2]) << 16) | (static_cast<uint32_t>(sites[3]) << 24);
+
+		detail::forRowsCounting(
+			pool, sizeY, sizeX * 3, statistics, [=](size_t first, size_t last, uint32_t *histogram) {
+				detail::demosaicRows(in, pixels, sizeX, sizeY, first, last, packedSites, histogram);
+			});
+	}
+};
+
+template<>
+struct Converter<IMU6_EVENT> {
+	using Output = dv::IMUPacket;
+
+	static constexpr const char *OUTPUT_NAME = "imu";
+
+	static void convert(caerEventPacketHeaderConst packet, Output &out, int32_t begin = 0, int32_t end = INT32_MAX) {
+		detail::appendDecoded<struct caer_imu6_event>(packet, begin, end, out.elements, detail::decodeIMU6);
+	}
+
+	// Same, in the same pass also appending to a structure of arrays.
+	static void convert(caerEventPacketHeaderConst packet, Output &out, IMUArrays &arrays, int32_t begin = 0,
+		int32_t end = INT32_MAX) {
+		end = detail::rangeEnd(packet, end);
+
+		if (begin >= end) {
+			return;
+		}
+
+		// Uninitialized until written, trimmed to the valid samples below.
+		auto offset = arrays.size();
+		arrays.resize(offset + static_cast<size_t>(end - begin));
+
+		detail::appendDecoded<struct caer_imu6_event>(packet, begin, end, out.elements,
+			[&arrays, &offset](const struct caer_imu6_event *in, size_t count, int64_t tsOverflow, dv::IMU *elements) {
+				auto written = detail::decodeIMU6Arrays(in, count, tsOverflow, elements, &arrays, offset);
+				offset += written;
+
+				return (written);
+			});
+
+		arrays.resize(offset);
+	}
+
+	static int64_t newestTimestamp(const Output &out) {
+		return (out.elements.back().timestamp);
+	}
+};
+
+template<>
+struct Converter<SPECIAL_EVENT> {
+	using Output = dv::TriggerPacket;
+
+	static constexpr const char *OUTPUT_NAME = "triggers";
+
+	// Only trigger types in 'filter' (see triggerBit()) are converted.
+	static void convert(caerEventPacketHeaderConst packet, Output &out, int32_t begin = 0, int32_t end = INT32_MAX,
+		uint32_t filter = ALL_TRIGGERS) {
+		detail::appendDecoded<struct caer_special_event>(packet, begin, end, out.elements,
+			[filter](const struct caer_special_event *in, size_t count, int64_t tsOverflow, dv::Trigger *elements) {
+				return (detail::decodeSpecial(in, count, tsOverflow, filter, elements));
+			});
+	}
+
+	static int64_t newestTimestamp(const Output &out) {
+		return (out.elements.back().timestamp);
+	}
+};
+
+/**
+ * Shorthand for Converter<EventType>::convert().
+ */
+template<int16_t EventType, typename... Args>
+inline auto convert(caerEventPacketHeaderConst packet, Args &&... args) {
+	return (Converter<EventType>::convert(packet, std::forward<Args>(args)...));
+}
+
+} // namespace Aedat4Convert
+
+#endif // AEDAT4_CONVERTER_HPP
@@ -0,0 +1,269 @@
+#ifndef ASYNC_LOG_HPP
+#define ASYNC_LOG_HPP
+
+#include "log.hpp"
+#include "spsc_queue.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+namespace dv::LoggerInternal {
+
+/**
+ * Non-blocking front end to LogInternal(), for threads that must not stall on
+ * log I/O: the libcaer acquisition thread, the mainloop hot path.
+ *
+ * Each logging thread gets its own lock-free ring of fixed-size records, so
+ * after a thread's first record logging neither locks nor allocates. A
+ * background flusher drains all rings every FLUSH_PERIOD (or on flush()), sorts
+ * the batch by time and hands it to LogInternal() under each record's log
+ * block, which writes DV_LOG_FILE_NAME and the console as for any other
+ * message. Records that don't fit a full ring are dropped and counted, and the
+ * flusher reports the count with the next batch.
+ *
+ * Log blocks must outlive their records: modules call flush() before going
+ * away. The flusher drains everything once more when the library unloads.
+ */
+class AsyncLog {
+public:
+	static constexpr size_t RING_RECORDS = 1024;
+	static constexpr size_t TEXT_SIZE    = 240;
+	static constexpr auto FLUSH_PERIOD   = std::chrono::milliseconds(50);
+
+	static AsyncLog &instance() {
+		static AsyncLog asyncLog;
+
+		return (asyncLog);
+	}
+
+	AsyncLog(const AsyncLog &)            = delete;
+	AsyncLog &operator=(const AsyncLog &) = delete;
+
+	~AsyncLog() {
+		{
+			std::scoped_lock lock(flushLock);
+
+			stopping = true;
+		}
+
+		wake.notify_one();
+		flusher.join();
+	}
+
+	/**
+	 * Queue 'message' for 'block' (the module's, Get() on its threads). Texts
+	 * longer than TEXT_SIZE are truncated. Returns false if filtered by the
+	 * block's level or dropped.
+	 */
+	bool log(const LogBlock *block, dv::logLevel level, std::string_view message) {
+		if ((block != nullptr) && (level > block->logLevel.load(std::memory_order_relaxed))) {
+			return (false);
+		}
+
+		auto &ring = threadRing();
+
+		Record record;
+		record.time   = std::chrono::steady_clock::now().time_since_epoch().count();
+		record.block  = block;
+		record.level  = level;
+		record.length = std::min(message.size(), TEXT_SIZE);
+		std::memcpy(record.text, message.data(), record.length);
+
+		if (!ring.records.push(std::move(record))) {
+			ring.dropped.fetch_add(1, std::memory_order_relaxed);
+			ring.dropBlock.store(block, std::memory_order_relaxed);
+			return (false);
+		}
+
+		return (true);
+	}
+
+	bool log(dv::logLevel level, std::string_view message) {
+		return (log(Get(), level, message));
+	}
+
+	/**
+	 * Wait until everything queued before this call has been written.
+	 */
+	void flush() {
+		std::unique_lock lock(flushLock);
+
+		auto target = ++flushRequested;
+
+		wake.notify_one();
+
+		flushed.wait(lock, [this, target] {
+			return (flushCompleted >= target);
+		});
+	}
+
+	/**
+	 * Records dropped on full rings since the process started.
+	 */
+	int64_t droppedRecords() const {
+		return (droppedTotal.load(std::memory_order_relaxed));
+	}
+
+private:
+	struct Record {
+		int64_t time;
+		const LogBlock *block;
+		dv::logLevel level;
+		size_t length;
+		char text[TEXT_SIZE];
+	};
+
+	struct Ring {
+		SPSCQueue<Record> records{RING_RECORDS};
+		std::atomic<int64_t> dropped{0};
+		std::atomic<const LogBlock *> dropBlock{nullptr};
+		// Owning thread exited, remove once drained.
+		std::atomic<bool> orphaned{false};
+	};
+
+	std::mutex ringsLock;
+	std::vector<std::shared_ptr<Ring>> rings;
+
+	std::mutex flushLock;
+	std::condition_variable wake;
+	std::condition_variable flushed;
+	uint64_t flushRequested{0};
+	uint64_t flushCompleted{0};
+	bool stopping{false};
+
+	std::atomic<int64_t> droppedTotal{0};
+
+	std::thread flusher;
+
+	AsyncLog() : flusher(&AsyncLog::run, this) {
+	}
+
+	Ring &threadRing() {
+		struct Owner {
+			std::shared_ptr<Ring> ring;
+
+			~Owner() {
+				if (ring) {
+					ring->orphaned.store(true, std::memory_order_release);
+				}
+			}
+		};
+
+		thread_local Owner owner;
+
+		if (!owner.ring) {
+			// Once per thread.
+			owner.ring = std::make_shared<Ring>();
+
+			std::scoped_lock lock(ringsLock);
+			rings.push_back(owner.ring);
+		}
+
+		return (*owner.ring);
+	}
+
+	void run() {
+		std::vector<Record> batch;
+		batch.reserve(RING_RECORDS);
+
+		std::unique_lock lock(flushLock);
+
+		while (true) {
+			wake.wait_for(lock, FLUSH_PERIOD, [this] {
+				return (stopping || (flushRequested != flushCompleted));
+			});
+
+			auto target = flushRequested;
+			auto last   = stopping;
+
+			lock.unlock();
+
+			drain(batch);
+			write(batch);
+
+			lock.lock();
+
+			flushCompleted = target;
+			flushed.notify_all();
+
+			if (last) {
+				break;
+			}
+		}
+	}
+
+	void drain(std::vector<Record> &batch) {
+		std::vector<std::shared_ptr<Ring>> current;
+
+		{
+			std::scoped_lock lock(ringsLock);
+
+			// Orphaned before draining means nothing can be added after.
+			rings.erase(std::remove_if(rings.begin(), rings.end(),
+							[](const std::shared_ptr<Ring> &ring) {
+								return (ring->orphaned.load(std::memory_order_acquire) && ring->records.empty());
+							}),
+				rings.end());
+
+			current = rings;
+		}
+
+		batch.clear();
+
+		for (const auto &ring : current) {
+			Record record;
+
+			while (ring->records.pop(record)) {
+				batch.push_back(record);
+			}
+
+			if (auto dropped = ring->dropped.exchange(0, std::memory_order_relaxed); dropped > 0) {
+				droppedTotal.fetch_add(dropped, std::memory_order_relaxed);
+
+				Record report;
+				report.time  = std::chrono::steady_clock::now().time_since_epoch().count();
+				report.block = ring->dropBlock.load(std::memory_order_relaxed);
+				report.level = dv::logLevel::WARNING;
+
+				auto text = std::to_string(dropped) + " log messages dropped, logging faster than they can be written.";
+
+				report.length = std::min(text.size(), TEXT_SIZE);
+				std::memcpy(report.text, text.data(), report.length);
+
+				batch.push_back(report);
+			}
+		}
+
+		// Rings are per thread, interleave them back in time order.
+		std::stable_sort(batch.begin(), batch.end(), [](const Record &a, const Record &b) {
+			return (a.time < b.time);
+		});
+	}
+
+	static void write(const std::vector<Record> &batch) {
+		const LogBlock *current = Get();
+
+		for (const auto &record : batch) {
+			if (record.block != current) {
+				current = record.block;
+				Set(current);
+			}
+
+			LogInternal(record.level, std::string_view(record.text, record.length));
+		}
+	}
+};
+
+} // namespace dv::LoggerInternal
+
+#endif // ASYNC_LOG_HPP
@@ -0,0 +1,148 @@
+#ifndef CLOCK_DRIFT_HPP
+#define CLOCK_DRIFT_HPP
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+
+/**
+ * Estimates the mapping from device timestamps to host (Unix) time.
+ *
+ * Every container gives a sample: its newest device timestamp and the host time
+ * it arrived at. Their difference is the offset plus a transfer delay that is
+ * always positive, so per window (one second of device time) only the minimum
+ * difference is kept, the lower envelope. A weighted least-squares line is fit
+ * through these minima, older windows fading out over 'horizon' seconds.
+ *
+ * With x in seconds of device time and y the offset in µs, the slope is
+ * directly the skew in ppm (µs per s). The remaining minimum transfer delay
+ * (typically well below a millisecond over USB) is included in the offset.
+ */
+class ClockDriftEstimator {
+public:
+	struct Estimate {
+		int64_t offset;    // µs, host time = device timestamp + offset, at the newest sample.
+		double skew;       // ppm, host clock rate relative to device clock.
+		double confidence; // 0 to 1, 1 meaning the offset is known much better than 1 ms.
+		int64_t windows;   // Windows the estimate is based on.
+	};
+
+	void reset() {
+		sumW = sumX = sumY = sumXX = sumXY = sumYY = 0;
+		windows    = 0;
+		windowOpen = false;
+	}
+
+	void setHorizon(double seconds) {
+		horizon = std::max(seconds, WINDOW_SECONDS);
+	}
+
+	/**
+	 * Add a sample. Returns true when a window was closed and the estimate changed.
+	 */
+	bool addSample(int64_t deviceTimestamp, int64_t hostTime) {
+		if (!windowOpen) {
+			if (windows == 0) {
+				origin = deviceTimestamp;
+			}
+
+			windowOpen    = true;
+			windowStart   = deviceTimestamp;
+			windowMin     = INT64_MAX;
+			windowMinTime = deviceTimestamp;
+		}
+
+		if ((hostTime - deviceTimestamp) < windowMin) {
+			windowMin     = hostTime - deviceTimestamp;
+			windowMinTime = deviceTimestamp;
+		}
+
+		newestTimestamp = deviceTimestamp;
+
+		if ((deviceTimestamp - windowStart) < static_cast<int64_t>(WINDOW_SECONDS * 1000000)) {
+			return (false);
+		}
+
+		windowOpen = false;
+
+		// Relative to the first window, for precision.
+		if (windows == 0) {
+			yOrigin = windowMin;
+		}
+
+		double x = static_cast<double>(windowMinTime - origin) / 1000000.0;
+		double y = static_cast<double>(windowMin - yOrigin);
+
+		double decay = std::exp(-WINDOW_SECONDS / horizon);
+
+		sumW  = (sumW * decay) + 1;
+		sumX  = (sumX * decay) + x;
+		sumY  = (sumY * decay) + y;
+		sumXX = (sumXX * decay) + (x * x);
+		sumXY = (sumXY * decay) + (x * y);
+		sumYY = (sumYY * decay) + (y * y);
+
+		windows++;
+
+		return (true);
+	}
+
+	Estimate estimate() const {
+		Estimate result = {0, 0, 0, windows};
+
+		if (windows == 0) {
+			return (result);
+		}
+
+		double meanX = sumX / sumW;
+		double meanY = sumY / sumW;
+		double varX  = (sumXX / sumW) - (meanX * meanX);
+
+		double slope = 0;
+		if ((windows >= MIN_WINDOWS_FOR_SKEW) && (varX > 0)) {
+			slope = ((sumXY / sumW) - (meanX * meanY)) / varX;
+		}
+
+		double intercept = meanY - (slope * meanX);
+
+		double xNow = static_cast<double>(newestTimestamp - origin) / 1000000.0;
+
+		result.offset = yOrigin + static_cast<int64_t>(std::llround(intercept + (slope * xNow)));
+		result.skew   = slope;
+
+		if (windows >= MIN_WINDOWS_FOR_SKEW) {
+			// Residual variance, with the effective number of windows.
+			double varY     = (sumYY / sumW) - (meanY * meanY);
+			double residual = std::max(varY - (slope * slope * varX), 0.0);
+			double n        = sumW;
+
+			// Standard error of the line at xNow.
+			double error = std::sqrt(residual / std::max(n - 2, 1.0)
+									 * (1 + ((varX > 0) ? (((xNow - meanX) * (xNow - meanX)) / varX) : (0))));
+
+			result.confidence = std::clamp(1.0 - (error / 1000.0), 0.0, 1.0);
+		}
+
+		return (result);
+	}
+
+private:
+	static constexpr double WINDOW_SECONDS        = 1.0;
+	static constexpr int64_t MIN_WINDOWS_FOR_SKEW = 3;
+
+	double horizon{300};
+
+	int64_t origin{0};
+	int64_t yOrigin{0};
+	int64_t newestTimestamp{0};
+
+	bool windowOpen{false};
+	int64_t windowStart{0};
+	int64_t windowMin{INT64_MAX};
+	int64_t windowMinTime{0};
+
+	int64_t windows{0};
+	double sumW{0}, sumX{0}, sumY{0}, sumXX{0}, sumXY{0}, sumYY{0};
+};
+
+#endif // CLOCK_DRIFT_HPP
@@ -0,0 +1,114 @@
+#ifndef CONTAINER_CONTROLLER_HPP
+#define CONTAINER_CONTROLLER_HPP
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+
+/**
+ * Adaptive sizing of libcaer EventPacketContainers.
+ *
+ * Per measurement window the controller gets the number of events and
+ * containers seen and the host time spent processing them. Assuming processing
+ * cost scales with the number of events, a container spanning interval I is
+ * fully delivered after about I * (1 + cost * rate), so the largest interval
+ * that still meets the latency bound is chosen, but never less than the
+ * minimum interval (the overhead bound). The maximum packet size is set to
+ * twice the events expected per interval, to cut containers short on bursts.
+ */
+class ContainerController {
+public:
+	struct Bounds {
+		int32_t targetLatency; // µs
+		int32_t minInterval;   // µs
+	};
+
+	struct Result {
+		int32_t interval;      // µs
+		int32_t maxPacketSize; // events
+	};
+
+	void addContainer(int64_t events, int64_t processingTime) {
+		windowEvents += events;
+		windowProcessingTime += processingTime;
+		windowContainers++;
+	}
+
+	/**
+	 * Close a measurement window of the given duration (µs). Returns true and
+	 * fills 'result' if the settings should change.
+	 */
+	bool update(int64_t windowDuration, const Bounds &bounds, int32_t currentInterval, Result &result) {
+		if ((windowDuration <= 0) || (windowContainers == 0)) {
+			resetWindow();
+			return (false);
+		}
+
+		double rate = static_cast<double>(windowEvents) * 1000000.0 / static_cast<double>(windowDuration);
+		double cost = (windowEvents > 0)
+						  ? (static_cast<double>(windowProcessingTime) / static_cast<double>(windowEvents))
+						  : (0);
+
+		resetWindow();
+
+		// Smooth over windows, scene activity is bursty.
+		smoothedRate = (initialized) ? (SMOOTHING * rate + (1 - SMOOTHING) * smoothedRate) : (rate);
+		smoothedCost = (initialized) ? (SMOOTHING * cost + (1 - SMOOTHING) * smoothedCost) : (cost);
+		initialized  = true;
+
+		// Processing cost is µs per event, rate is events per second.
+		double load = smoothedCost * smoothedRate / 1000000.0;
+
+		auto maxInterval = std::max(bounds.targetLatency, bounds.minInterval);
+
+		auto interval = static_cast<int32_t>(static_cast<double>(bounds.targetLatency) / (1.0 + load));
+		interval      = std::clamp(interval, bounds.minInterval, maxInterval);
+
+		auto expectedEvents = smoothedRate * static_cast<double>(interval) / 1000000.0;
+		auto maxPacketSize  = static_cast<int32_t>(std::min(std::ceil(2 * expectedEvents), MAX_PACKET_SIZE));
+		maxPacketSize       = std::max(maxPacketSize, MIN_PACKET_SIZE);
+
+		// Hysteresis: only retune on significant changes.
+		bool intervalChanged = std::abs(interval - currentInterval) > (currentInterval / 10);
+		bool sizeChanged     = std::abs(maxPacketSize - lastMaxPacketSize) > (lastMaxPacketSize / 10);
+
+		if (!intervalChanged && !sizeChanged) {
+			return (false);
+		}
+
+		lastMaxPacketSize = maxPacketSize;
+
+		result.interval      = (intervalChanged) ? (interval) : (currentInterval);
+		result.maxPacketSize = maxPacketSize;
+
+		return (true);
+	}
+
+	void reset() {
+		resetWindow();
+		initialized       = false;
+		lastMaxPacketSize = 0;
+	}
+
+private:
+	static constexpr double SMOOTHING        = 0.3;
+	static constexpr double MAX_PACKET_SIZE  = 10 * 1024 * 1024;
+	static constexpr int32_t MIN_PACKET_SIZE = 128;
+
+	int64_t windowEvents{0};
+	int64_t windowContainers{0};
+	int64_t windowProcessingTime{0};
+
+	bool initialized{false};
+	double smoothedRate{0};
+	double smoothedCost{0};
+	int32_t lastMaxPacketSize{0};
+
+	void resetWindow() {
+		windowEvents         = 0;
+		windowContainers     = 0;
+		windowProcessingTime = 0;
+	}
+};
+
+#endif // CONTAINER_CONTROLLER_HPP
@@ -12,12 +12,140 @@
 // #include "dv-sdk/log.hpp"
 #include "log.hpp"
 #include "aedat4_convert.hpp"
+#include "aedat4_converter.hpp"
+#include "async_log.hpp"
+#include "clock_drift.hpp"
+#include "container_controller.hpp"
+#include "davis_statistics.hpp"
+#include "exchange_queue.hpp"
+#include "latency.hpp"
+#include "presync_buffer.hpp"
+#include "rate_governor.hpp"
+#include "raw_passthrough.hpp"
+#include "raw_recorder.hpp"
+#include "replay_source.hpp"
+#include "simd_dispatch.hpp"
+#include "thread_affinity.hpp"
+#include "thread_pool.hpp"
+#include "timestamp_reset.hpp"
 
 #include <libcaercpp/devices/davis.hpp>
 
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+
 class davis : public dv::ModuleBase {
 private:
-	libcaer::devices::davis device;
+	// Exactly one of these is set: a live camera, or a raw capture being replayed.
+	std::unique_ptr<libcaer::devices::davis> device;
+	std::unique_ptr<ReplaySource> replay;
+
+	DavisStatisticsPoller statistics;
+
+	// Auto-reconnect state. deviceLost is set from the libcaer thread.
+	std::string deviceSerialNumber;
+	std::atomic_bool deviceLost{false};
+	std::chrono::steady_clock::time_point deviceLostTime;
+	std::chrono::steady_clock::time_point reconnectLastAttempt;
+	int64_t reconnectCount{0};
+	int64_t reconnectTotalDowntime{0};
+
+	// SIMD variant of this instance's conversions, see Simd::Scope.
+	Simd::Level simdLevel{Simd::detect()};
+
+	// This module's log block, for messages queued from other threads through AsyncLog.
+	const dv::LoggerInternal::LogBlock *logBlock{dv::LoggerInternal::Get()};
+
+	// Latency instrumentation, per output. Only used from the mainloop thread.
+	static constexpr std::array<const char *, 4> latencyOutputs{{"events", "frames", "triggers", "imu"}};
+	std::array<OutputLatency, 4> latency;
+	std::chrono::steady_clock::time_point latencyLastPublish;
+	int64_t tsOffset{0};
+
+	// Adaptive packet-container sizing.
+	ContainerController containerController;
+	std::chrono::steady_clock::time_point containerWindowStart;
+
+	// Raw capture recording, started/stopped at runtime from the mainloop. Fed by
+	// drainDevice(), swapped under drainLock.
+	RawCapture::FileHeader recorderFileHeader;
+	std::unique_ptr<RawRecorder> recorder;
+	std::chrono::steady_clock::time_point recorderLastPublish;
+
+	// Frame statistics publishing, rate-limited. Only used from the mainloop thread.
+	std::chrono::milliseconds frameStatisticsInterval{200};
+	std::chrono::steady_clock::time_point frameStatisticsLastPublish;
+
+	// Raw containers and IMU arrays to in-process consumers, channels named after the camera.
+	RawPassthrough *rawPassthrough{nullptr};
+	Passthrough<Aedat4Convert::IMUArrays> *imuArraysPassthrough{nullptr};
+
+	// Data seen before the sync, only used from the mainloop thread.
+	PreSyncBuffer preSync;
+	size_t preSyncFramePixels{0};
+
+	// Newest device timestamp of the previous container, to place data around a reset.
+	int64_t lastDeviceTimestamp{INT64_MAX};
+
+	// Device to host clock mapping, restarted on every timestamp reset.
+	ClockDriftEstimator clockDrift;
+
+	// Thread placement. The libcaer acquisition thread applies its settings
+	// itself, from the data notification, and leaves a report behind.
+	std::mutex affinityLock;
+	std::vector<int> acquisitionCores;
+	int acquisitionPriority{0};
+	std::string acquisitionReport;
+	std::atomic_bool acquisitionPending{false};
+	std::atomic_bool acquisitionReportReady{false};
+	std::string acquisitionSettings;
+	std::string conversionSettings;
+
+	// Containers from the acquisition thread, with the overflow policy. Filled
+	// from the data notification, which drains libcaer's own ring right away,
+	// and from the mainloop after each pop (drainDevice()).
+	ExchangeQueue exchange;
+	std::mutex drainLock;
+	std::chrono::steady_clock::time_point exchangeLastPublish;
+	int64_t exchangeLastDropTime{0};
+
+	// Event rate limiting through the FPGA filters. Only the device is changed,
+	// the dvs/ configuration keeps the user's settings to go back to.
+	// Settings are read in configUpdate(), run() only uses the copies.
+	RateGovernor rateGovernor;
+	bool rateGovernorEnable{false};
+	double rateGovernorTargetRate{0};
+	RateGovernor::Settings rateGovernorConfigured{false, 0, false, 0, false, 1};
+	struct caer_davis_info rateGovernorDevInfo{};
+	bool rateGovernorActive{false};
+	std::chrono::steady_clock::time_point rateGovernorWindowStart;
+
+	// Trigger types sent to the 'triggers' output, from triggerFilter/.
+	static constexpr std::pair<const char *, dv::TriggerType> TRIGGER_FILTER_TYPES[] = {
+		{"TimestampReset", dv::TriggerType::TIMESTAMP_RESET},
+		{"ExternalSignalRisingEdge", dv::TriggerType::EXTERNAL_SIGNAL_RISING_EDGE},
+		{"ExternalSignalFallingEdge", dv::TriggerType::EXTERNAL_SIGNAL_FALLING_EDGE},
+		{"ExternalSignalPulse", dv::TriggerType::EXTERNAL_SIGNAL_PULSE},
+		{"ExternalGeneratorRisingEdge", dv::TriggerType::EXTERNAL_GENERATOR_RISING_EDGE},
+		{"ExternalGeneratorFallingEdge", dv::TriggerType::EXTERNAL_GENERATOR_FALLING_EDGE},
+		{"APSFrameStart", dv::TriggerType::APS_FRAME_START},
+		{"APSFrameEnd", dv::TriggerType::APS_FRAME_END},
+		{"APSExposureStart", dv::TriggerType::APS_EXPOSURE_START},
+		{"APSExposureEnd", dv::TriggerType::APS_EXPOSURE_END},
+	};
+
+	// Trigger filter and frame workers, see updateConversionOptions().
+	dvConvertOptions conversionOptions;
+	std::unique_ptr<ThreadPool> framePool;
+
+	// Polarity events region of interest, fixed at module start since the output size depends on it.
+	Aedat4Convert::EventROI eventROI;
 
 public:
 	static void initOutputs(dv::OutputDefinitionList &out) {
@@ -48,26 +176,67 @@ public:
 		externalInputConfigCreate(config);
 		usbConfigCreate(config);
 		systemConfigCreate(config);
+		reconnectConfigCreate(config);
+		replayConfigCreate(config);
+		recorderConfigCreate(config);
+		rawOutputConfigCreate(config);
+		preSyncConfigCreate(config);
+		clockConfigCreate(config);
+		rateGovernorConfigCreate(config);
+		simdConfigCreate(config);
+		triggerFilterConfigCreate(config);
+		softwareROIConfigCreate(config);
 	}
 
-	davis() :
-		device(0, static_cast<uint8_t>(config.getInt("busNumber")), static_cast<uint8_t>(config.getInt("devAddress")),
-			config.getString("serialNumber")) {
-		// Initialize per-device log-level to module log-level.
-		device.configSet(CAER_HOST_CONFIG_LOG, CAER_HOST_CONFIG_LOG_LEVEL,
-			static_cast<uint32_t>(dv::LoggerInternal::logLevelNameToInteger(config.getString("logLevel"))));
+	davis() {
+		auto replayFile = config.getString("replay/File");
+
+		if (!replayFile.empty()) {
+			// Replay a raw capture instead of opening a camera.
+			replay = std::make_unique<ReplaySource>(replayFile, (config.getString("replay/Pace") == "Recorded"),
+				config.getBool("replay/Loop"), config.getBool("replay/InjectTimestampReset"));
+		}
+		else {
+			device = std::make_unique<libcaer::devices::davis>(0, static_cast<uint8_t>(config.getInt("busNumber")),
+				static_cast<uint8_t>(config.getInt("devAddress")), config.getString("serialNumber"));
+
+			// Initialize per-device log-level to module log-level.
+			device->configSet(CAER_HOST_CONFIG_LOG, CAER_HOST_CONFIG_LOG_LEVEL,
+				static_cast<uint32_t>(dv::LoggerInternal::logLevelNameToInteger(config.getString("logLevel"))));
+		}
+
+		auto devInfo = (device) ? (device->infoGet()) : (replay->infoGet());
+
+		// Remember which device we opened, so that reconnects find the same one.
+		deviceSerialNumber = devInfo.deviceSerialNumber;
+
+		recorderFileHeader = RawCapture::makeFileHeader(devInfo);
 
-		auto devInfo = device.infoGet();
+		// Largest possible frame: full sensor, RGBA.
+		preSyncFramePixels = static_cast<size_t>(devInfo.apsSizeX) * static_cast<size_t>(devInfo.apsSizeY) * 4;
 
 		// Generate source string for output modules.
 		auto sourceString = chipIDToName(devInfo.chipID, false) + "_" + devInfo.deviceSerialNumber;
 
+		setupEventROI(devInfo);
+
 		// Setup outputs.
-		outputs.getEventOutput("events").setup(device.infoGet().dvsSizeX, device.infoGet().dvsSizeY, sourceString);
-		outputs.getEventOutput("frames").setup(device.infoGet().apsSizeX, device.infoGet().apsSizeY, sourceString);
+		outputs.getEventOutput("events").setup(eventROI.outputSizeX(), eventROI.outputSizeY(), sourceString);
+		outputs.getEventOutput("frames").setup(devInfo.apsSizeX, devInfo.apsSizeY, sourceString);
 		outputs.getTriggerOutput("triggers").setup(sourceString);
 		outputs.getIMUOutput("imu").setup(sourceString);
 
+		rawPassthrough       = &RawPassthrough::channel(sourceString);
+		imuArraysPassthrough = &Passthrough<Aedat4Convert::IMUArrays>::channel(sourceString);
+
+		moduleNode.getRelativeNode("imuArrays/").create<dv::CfgType::STRING>("Channel", sourceString, {0, 64},
+			dv::CfgFlags::READ_ONLY | dv::CfgFlags::NO_EXPORT,
+			"Name of the Passthrough<Aedat4Convert::IMUArrays> channel carrying the IMU samples.");
+
+		moduleNode.getRelativeNode("rawOutput/").create<dv::CfgType::STRING>("Channel", sourceString, {0, 64},
+			dv::CfgFlags::READ_ONLY | dv::CfgFlags::NO_EXPORT,
+			"Name of the RawPassthrough channel carrying the raw libcaer containers.");
+
 		auto sourceInfoNode = moduleNode.getRelativeNode("sourceInfo/");
 
 		sourceInfoNode.create<dv::CfgType::STRING>("serialNumber", devInfo.deviceSerialNumber, {0, 8},
@@ -130,11 +299,13 @@ public:
 			dv::CfgFlags::READ_ONLY | dv::CfgFlags::NO_EXPORT, "Device source information.");
 
 		// Ensure good defaults for data acquisition settings.
-		// No blocking behavior due to mainloop notification, and no auto-start of
-		// all producers to ensure cAER settings are respected.
-		device.configSet(CAER_HOST_CONFIG_DATAEXCHANGE, CAER_HOST_CONFIG_DATAEXCHANGE_BLOCKING, true);
-		device.configSet(CAER_HOST_CONFIG_DATAEXCHANGE, CAER_HOST_CONFIG_DATAEXCHANGE_START_PRODUCERS, false);
-		device.configSet(CAER_HOST_CONFIG_DATAEXCHANGE, CAER_HOST_CONFIG_DATAEXCHANGE_STOP_PRODUCERS, true);
+		// No blocking behavior, libcaer's ring is drained from the data notification,
+		// and no auto-start of all producers to ensure cAER settings are respected.
+		if (device) {
+			device->configSet(CAER_HOST_CONFIG_DATAEXCHANGE, CAER_HOST_CONFIG_DATAEXCHANGE_BLOCKING, false);
+			device->configSet(CAER_HOST_CONFIG_DATAEXCHANGE, CAER_HOST_CONFIG_DATAEXCHANGE_START_PRODUCERS, false);
+			device->configSet(CAER_HOST_CONFIG_DATAEXCHANGE, CAER_HOST_CONFIG_DATAEXCHANGE_STOP_PRODUCERS, true);
+		}
 
 		// DVS240 supports only either Events or Frames. We use the
 		// IMU Type field to recognize new generation devices.
@@ -168,203 +339,1033 @@ public:
 		int64_t tsNowOffset
 			= static_cast<int64_t>(tsNow.tv_sec * 1000000LL) + static_cast<int64_t>(tsNow.tv_nsec / 1000LL);
 
-		sourceInfoNode.create<dv::CfgType::LONG>("tsOffset", tsNowOffset, {0, INT64_MAX},
-			dv::CfgFlags::READ_ONLY | dv::CfgFlags::NO_EXPORT,
-			"Time offset of data stream starting point to Unix time in µs.");
+		tsOffset = tsNowOffset;
+
+		sourceInfoNode.create<dv::CfgType::LONG>("tsOffset", tsNowOffset, {0, INT64_MAX},
+			dv::CfgFlags::READ_ONLY | dv::CfgFlags::NO_EXPORT,
+			"Time offset of data stream starting point to Unix time in µs.");
+
+		moduleNode.getRelativeNode("outputs/events/info/")
+			.create<dv::CfgType::LONG>("tsOffset", tsNowOffset, {0, INT64_MAX},
+				dv::CfgFlags::READ_ONLY | dv::CfgFlags::NO_EXPORT,
+				"Time offset of data stream starting point to Unix time in µs.");
+
+		moduleNode.getRelativeNode("outputs/frames/info/")
+			.create<dv::CfgType::LONG>("tsOffset", tsNowOffset, {0, INT64_MAX},
+				dv::CfgFlags::READ_ONLY | dv::CfgFlags::NO_EXPORT,
+				"Time offset of data stream starting point to Unix time in µs.");
+
+		moduleNode.getRelativeNode("outputs/triggers/info/")
+			.create<dv::CfgType::LONG>("tsOffset", tsNowOffset, {0, INT64_MAX},
+				dv::CfgFlags::READ_ONLY | dv::CfgFlags::NO_EXPORT,
+				"Time offset of data stream starting point to Unix time in µs.");
+
+		moduleNode.getRelativeNode("outputs/imu/info/")
+			.create<dv::CfgType::LONG>("tsOffset", tsNowOffset, {0, INT64_MAX},
+				dv::CfgFlags::READ_ONLY | dv::CfgFlags::NO_EXPORT,
+				"Time offset of data stream starting point to Unix time in µs.");
+
+		for (const auto &output : latencyOutputs) {
+			OutputLatency::createAttributes(moduleNode.getRelativeNode("latency/" + std::string(output) + "/"));
+		}
+
+		auto clockNode = moduleNode.getRelativeNode("clock/");
+
+		clockNode.create<dv::CfgType::LONG>("offset", tsNowOffset, {INT64_MIN, INT64_MAX},
+			dv::CfgFlags::READ_ONLY | dv::CfgFlags::NO_EXPORT,
+			"Estimated current offset of device timestamps to Unix time in µs.");
+		clockNode.create<dv::CfgType::DOUBLE>("skew", 0.0, {-1000000, 1000000},
+			dv::CfgFlags::READ_ONLY | dv::CfgFlags::NO_EXPORT,
+			"Estimated host clock rate relative to the device clock, in ppm.");
+		clockNode.create<dv::CfgType::DOUBLE>("confidence", 0.0, {0, 1},
+			dv::CfgFlags::READ_ONLY | dv::CfgFlags::NO_EXPORT,
+			"Confidence in the estimated offset, 1 meaning known much better than 1 ms.");
+
+		moduleNode.getRelativeNode("simd/").create<dv::CfgType::STRING>("Variant", Simd::name(Simd::active()),
+			{0, 32}, dv::CfgFlags::READ_ONLY | dv::CfgFlags::NO_EXPORT, "SIMD code variant used for conversion.");
+
+		auto frameStatisticsNode = moduleNode.getRelativeNode("frameStatistics/");
+
+		frameStatisticsNode.create<dv::CfgType::DOUBLE>("Mean", 0.0, {0, 255},
+			dv::CfgFlags::READ_ONLY | dv::CfgFlags::NO_EXPORT, "Mean 8 bit luminance of the last frame.");
+		frameStatisticsNode.create<dv::CfgType::DOUBLE>("ClippedDark", 0.0, {0, 1},
+			dv::CfgFlags::READ_ONLY | dv::CfgFlags::NO_EXPORT, "Fraction of pixels at 0 in the last frame.");
+		frameStatisticsNode.create<dv::CfgType::DOUBLE>("ClippedBright", 0.0, {0, 1},
+			dv::CfgFlags::READ_ONLY | dv::CfgFlags::NO_EXPORT, "Fraction of pixels at 255 in the last frame.");
+		frameStatisticsNode.create<dv::CfgType::STRING>("Histogram", "", {0, 4096},
+			dv::CfgFlags::READ_ONLY | dv::CfgFlags::NO_EXPORT,
+			"Luminance histogram of the last frame, 256 comma-separated pixel counts for values 0 to 255.");
+		frameStatisticsNode.create<dv::CfgType::LONG>("Timestamp", 0, {INT64_MIN, INT64_MAX},
+			dv::CfgFlags::READ_ONLY | dv::CfgFlags::NO_EXPORT,
+			"Timestamp of the frame the statistics are from, updated last.");
+
+		updateConversionOptions();
+
+		auto rateGovernorNode = moduleNode.getRelativeNode("rateGovernor/");
+
+		rateGovernorNode.create<dv::CfgType::DOUBLE>("Strength", 0.0, {0, 1},
+			dv::CfgFlags::READ_ONLY | dv::CfgFlags::NO_EXPORT,
+			"Current filter strength, 0 meaning the configured dvs/ filter settings.");
+		rateGovernorNode.create<dv::CfgType::DOUBLE>("Rate", 0.0, {0, 1000},
+			dv::CfgFlags::READ_ONLY | dv::CfgFlags::NO_EXPORT, "Measured event rate after the filters, in Mev/s.");
+
+		auto affinityNode = moduleNode.getRelativeNode("system/Affinity/");
+
+		affinityNode.create<dv::CfgType::STRING>("AcquisitionApplied", "", {0, 1024},
+			dv::CfgFlags::READ_ONLY | dv::CfgFlags::NO_EXPORT, "Current placement of the acquisition thread.");
+		affinityNode.create<dv::CfgType::STRING>("ConversionApplied", "", {0, 1024},
+			dv::CfgFlags::READ_ONLY | dv::CfgFlags::NO_EXPORT, "Current placement of the module thread.");
+
+		updateAffinity();
+
+		if (replay) {
+			// Nothing to configure, the capture already holds the device output.
+			return;
+		}
+
+		updateExchange();
+		updateRateGovernorSettings();
+
+		// Start data acquisition.
+		device->dataStart(&dataNotifyIncrease, nullptr, this, &moduleShutdownNotify, this);
+
+		// Send all configuration to the device.
+		sendDefaultConfiguration(&devInfo);
+
+		// Statistics are read in the background, readers only see cached values.
+		statistics.start(device.get(), moduleNode.getRelativeNode("system/"));
+
+		// Add config listeners last, to avoid having them dangling if Init doesn't succeed.
+		addConfigListeners(&devInfo);
+	}
+
+	~davis() override {
+		if (device) {
+			auto devInfo = device->infoGet();
+
+			// Remove listener, which can reference invalid memory in userData.
+			removeConfigListeners(&devInfo);
+
+			statistics.stop();
+
+			// Release the acquisition thread if it is blocked on a full queue.
+			exchange.stop();
+
+			// Stop data acquisition.
+			device->dataStop();
+
+			// Ensure Exposure value is coherent with libcaer.
+			moduleNode.getRelativeNode("aps/").attributeUpdaterRemoveAll();
+			moduleNode.getRelativeNode("aps/").putInt(
+				"Exposure", apsExposureUpdater(device.get(), "Exposure", DVCFG_TYPE_INT).iint);
+		}
+
+		// Remove statistics read modifiers.
+		if (moduleNode.existsRelativeNode("statistics/")) {
+			moduleNode.getRelativeNode("statistics/").attributeUpdaterRemoveAll();
+		}
+
+		// Clear sourceInfo node.
+		auto sourceInfoNode = moduleNode.getRelativeNode("sourceInfo/");
+		sourceInfoNode.removeAllAttributes();
+
+		// Queued messages reference logBlock, write them while it's still valid.
+		dv::LoggerInternal::AsyncLog::instance().flush();
+	}
+
+	void configUpdate() override {
+		auto variant = config.getString("simd/ForceVariant");
+		simdLevel    = Simd::resolve(variant);
+
+		if ((variant != "Auto") && (variant != Simd::name(simdLevel))) {
+			log.warning << "SIMD variant " << variant << " not supported by this CPU, using "
+						<< Simd::name(simdLevel) << "." << dv::logEnd;
+		}
+
+		moduleNode.getRelativeNode("simd/").updateReadOnly<dv::CfgType::STRING>("Variant", Simd::name(simdLevel));
+
+		updateConversionOptions();
+		updateAffinity();
+
+		if (!replay) {
+			updateExchange();
+			updateRateGovernorSettings();
+		}
+	}
+
+	void publishFrameStatistics(int64_t timestamp, const Aedat4Convert::FrameStatistics &statistics) {
+		// Every write notifies all config clients, don't do it at frame rate.
+		auto now = std::chrono::steady_clock::now();
+
+		if ((now - frameStatisticsLastPublish) < frameStatisticsInterval) {
+			return;
+		}
+
+		frameStatisticsLastPublish = now;
+
+		std::string histogram;
+		histogram.reserve(Aedat4Convert::FrameStatistics::BINS * 4);
+
+		for (size_t i = 0; i < Aedat4Convert::FrameStatistics::BINS; i++) {
+			histogram += (i == 0) ? ("") : (",");
+			histogram += std::to_string(statistics.histogram[i]);
+		}
+
+		auto statisticsNode = moduleNode.getRelativeNode("frameStatistics/");
+
+		statisticsNode.updateReadOnly<dv::CfgType::DOUBLE>("Mean", statistics.mean());
+		statisticsNode.updateReadOnly<dv::CfgType::DOUBLE>("ClippedDark", statistics.clippedDark());
+		statisticsNode.updateReadOnly<dv::CfgType::DOUBLE>("ClippedBright", statistics.clippedBright());
+		statisticsNode.updateReadOnly<dv::CfgType::STRING>("Histogram", histogram);
+		// Last, so that a listener on it sees the rest already updated.
+		statisticsNode.updateReadOnly<dv::CfgType::LONG>("Timestamp", timestamp);
+	}
+
+	void setupEventROI(const struct caer_davis_info &devInfo) {
+		auto startX = std::min(config.getInt("softwareROI/PositionX"), devInfo.dvsSizeX - 1);
+		auto startY = std::min(config.getInt("softwareROI/PositionY"), devInfo.dvsSizeY - 1);
+		auto sizeX  = config.getInt("softwareROI/SizeX");
+		auto sizeY  = config.getInt("softwareROI/SizeY");
+
+		// 0 or too large: up to the sensor edge.
+		sizeX = ((sizeX == 0) || (sizeX > (devInfo.dvsSizeX - startX))) ? (devInfo.dvsSizeX - startX) : (sizeX);
+		sizeY = ((sizeY == 0) || (sizeY > (devInfo.dvsSizeY - startY))) ? (devInfo.dvsSizeY - startY) : (sizeY);
+
+		auto downsample = config.getString("softwareROI/Downsample");
+
+		eventROI.startX = static_cast<int16_t>(startX);
+		eventROI.startY = static_cast<int16_t>(startY);
+		eventROI.sizeX  = static_cast<int16_t>(sizeX);
+		eventROI.sizeY  = static_cast<int16_t>(sizeY);
+		eventROI.shift  = (downsample == "4x4") ? (2) : ((downsample == "2x2") ? (1) : (0));
+
+		bool fullSensor = (startX == 0) && (startY == 0) && (sizeX == devInfo.dvsSizeX)
+						  && (sizeY == devInfo.dvsSizeY) && (eventROI.shift == 0);
+
+		conversionOptions.eventROI = (fullSensor) ? (nullptr) : (&eventROI);
+	}
+
+	void updateConversionOptions() {
+		uint32_t filter = 0;
+
+		for (const auto &[name, type] : TRIGGER_FILTER_TYPES) {
+			if (config.getBool("triggerFilter/" + std::string(name))) {
+				filter |= Aedat4Convert::triggerBit(type);
+			}
+		}
+
+		conversionOptions.triggerFilter = filter;
+		conversionOptions.demosaic      = config.getBool("aps/HostDemosaic");
+
+		frameStatisticsInterval = std::chrono::milliseconds(config.getInt("frameStatistics/PublishInterval"));
+
+		if (config.getBool("frameStatistics/Enable")) {
+			conversionOptions.frameStatistics
+				= [this](int64_t timestamp, const Aedat4Convert::FrameStatistics &statistics) {
+					  publishFrameStatistics(timestamp, statistics);
+				  };
+		}
+		else {
+			conversionOptions.frameStatistics = nullptr;
+		}
+
+		if (config.getBool("imuArrays/Enable")) {
+			conversionOptions.imuArrays = [this](std::shared_ptr<const Aedat4Convert::IMUArrays> arrays) {
+				imuArraysPassthrough->publish(arrays);
+			};
+		}
+		else {
+			conversionOptions.imuArrays = nullptr;
+		}
+
+		// Workers are only recreated on change, the pool is idle between conversions.
+		auto frameThreads = static_cast<size_t>(config.getInt("system/FrameConversionThreads"));
+
+		if (frameThreads == 0) {
+			framePool.reset();
+		}
+		else if (!framePool || (framePool->size() != frameThreads)) {
+			framePool = std::make_unique<ThreadPool>(frameThreads);
+		}
+
+		conversionOptions.framePool = framePool.get();
+	}
+
+	void run() override {
+		// This instance's variant, for all conversions below (and the frame pool workers).
+		Simd::Scope simdScope(simdLevel);
+
+		publishAcquisitionAffinity();
+
+		if (config.getBool("resetInitialization")) {
+			config.setBool("resetInitialization", false);
+			config.setBool("initialized", false);
+		}
+
+		if (deviceLost.load(std::memory_order_acquire)) {
+			reconnectDevice();
+			return;
+		}
+
+		std::shared_ptr<libcaer::events::EventPacketContainer> data;
+		int64_t dataArrivalTime;
+
+		if (replay) {
+			data            = replay->dataGet();
+			dataArrivalTime = realTimeClock();
+		}
+		else {
+			publishExchangeStatistics();
+
+			auto entry      = exchange.pop(std::chrono::milliseconds(10));
+			data            = std::move(entry.container);
+			dataArrivalTime = entry.arrivalTime;
+
+			// With Block, containers left in libcaer's ring are only picked up once there is room again.
+			drainDevice();
+		}
+
+		updateRecorder();
+
+		if (!data || data->empty()) {
+			return;
+		}
+
+		auto dataGetTime = dvConvertHostClock();
+
+		updateRateGovernor(*data);
+
+		if (replay && recorder) {
+			// Device data is recorded in drainDevice(), replayed data only here.
+			recorder->record(data, dataArrivalTime);
+		}
+
+		if (config.getBool("rawOutput/Enable") && rawPassthrough->hasSubscribers()) {
+			// Same packets, by reference, no copy. Replayed packets point into the
+			// mapped capture, unmapped on stop, so subscribers get their own copy.
+			rawPassthrough->publish((replay) ? (ownedContainerCopy(*data)) : (data));
+		}
+
+		publishLatency();
+
+		auto special = data->getEventPacket(SPECIAL_EVENT);
+
+		// The reset can share its special packet with other events (e.g. external input edges).
+		if (special && (TimestampReset::find(special->getHeaderPointer()) >= 0)) {
+			synchronize(*data, dataGetTime);
+		}
+		else {
+			if (special) {
+				convertPacket(special->getHeaderPointer(), dataGetTime);
+			}
+
+			if (!config.getBool("initialized")) {
+				if (config.getBool("preSync/Enable")) {
+					bufferPreSync(*data);
+				}
+
+				updateLastDeviceTimestamp(*data);
+				return;
+			}
+
+			for (auto type : {POLARITY_EVENT, FRAME_EVENT, IMU6_EVENT}) {
+				if (auto packet = data->getEventPacket(type)) {
+					convertPacket(packet->getHeaderPointer(), dataGetTime);
+				}
+			}
+		}
+
+		if (updateLastDeviceTimestamp(*data)) {
+			// Time of arrival, not of the pop: time spent queued is not transfer delay.
+			updateClockDrift(dataArrivalTime);
+		}
+
+		controlContainers(*data, dvConvertHostClock() - dataGetTime);
+	}
+
+private:
+	static void dataNotifyIncrease(void *p) {
+		auto module = static_cast<davis *>(p);
+
+		// Runs on the libcaer acquisition thread.
+		if (module->acquisitionPending.exchange(false, std::memory_order_acq_rel)) {
+			std::scoped_lock lock(module->affinityLock);
+
+			module->acquisitionReport = ThreadAffinity::apply(module->acquisitionCores, module->acquisitionPriority);
+			module->acquisitionReportReady.store(true, std::memory_order_release);
+		}
+
+		// Called right after each container is put into libcaer's ring: move it
+		// over, so the overflow policy is ours and not libcaer's (drop newest).
+		module->drainDevice();
+	}
+
+	/**
+	 * Move containers from libcaer's ring to the exchange queue, from the
+	 * acquisition thread and the mainloop. Never waits for room: this runs
+	 * inside libusb's event handling, which also completes the control
+	 * transfers the mainloop may be waiting on. Containers are recorded here,
+	 * before the overflow policy can drop anything.
+	 */
+	void drainDevice() {
+		std::scoped_lock lock(drainLock);
+
+		while (exchange.accepts()) {
+			auto container = device->dataGet();
+			if (!container) {
+				break;
+			}
+
+			auto arrivalTime = realTimeClock();
+
+			if (recorder) {
+				// Before the overflow policy: this is exactly what libcaer delivered.
+				recorder->record(container, arrivalTime);
+			}
+
+			exchange.push(std::move(container), arrivalTime);
+		}
+	}
+
+	void updateExchange() {
+		exchange.configure(static_cast<size_t>(config.getInt("system/DataExchangeBufferSize")),
+			ExchangeQueue::parsePolicy(config.getString("system/DataExchangePolicy")));
+	}
+
+	void publishExchangeStatistics() {
+		auto now = std::chrono::steady_clock::now();
+
+		if ((now - exchangeLastPublish) < std::chrono::seconds(1)) {
+			return;
+		}
+
+		exchangeLastPublish = now;
+
+		auto drops    = exchange.drops();
+		auto statNode = moduleNode.getRelativeNode("statistics/");
+
+		statNode.updateReadOnly<dv::CfgType::LONG>("exchangeDroppedContainers", drops.containers);
+		statNode.updateReadOnly<dv::CfgType::LONG>("exchangeDroppedEvents", drops.events);
+		statNode.updateReadOnly<dv::CfgType::LONG>("exchangeDroppedFrames", drops.frames);
+		statNode.updateReadOnly<dv::CfgType::LONG>("exchangeDroppedIMU", drops.imu);
+		statNode.updateReadOnly<dv::CfgType::LONG>("exchangeDroppedSpecial", drops.special);
+		statNode.updateReadOnly<dv::CfgType::LONG>("exchangeLastDropTime", drops.lastTime);
+		statNode.updateReadOnly<dv::CfgType::LONG>(
+			"exchangeHighWater", static_cast<int64_t>(exchange.takeHighWater()));
+
+		if (drops.lastTime != exchangeLastDropTime) {
+			exchangeLastDropTime = drops.lastTime;
+
+			// Keeps happening while the mainloop is behind, don't slow it down further with log I/O.
+			dv::LoggerInternal::AsyncLog::instance().log(logBlock, dv::logLevel::WARNING,
+				"Mainloop fell behind, data exchange queue dropped data (total: " + std::to_string(drops.containers)
+					+ " containers, " + std::to_string(drops.events) + " events, " + std::to_string(drops.frames)
+					+ " frames, " + std::to_string(drops.imu) + " IMU samples, " + std::to_string(drops.special)
+					+ " special events).");
+		}
+	}
+
+	/**
+	 * Apply changed placement settings, from configUpdate() on the mainloop
+	 * thread. The acquisition thread picks up its own on the next notification.
+	 */
+	void updateAffinity() {
+		auto affinityNode = moduleNode.getRelativeNode("system/Affinity/");
+
+		auto conversionCores    = config.getString("system/Affinity/ConversionCores");
+		auto conversionPriority = config.getInt("system/Affinity/ConversionPriority");
+		auto settings           = conversionCores + "/" + std::to_string(conversionPriority);
+
+		if (settings != conversionSettings) {
+			conversionSettings = settings;
+
+			// The mainloop thread, running this module's conversion.
+			affinityNode.updateReadOnly<dv::CfgType::STRING>("ConversionApplied",
+				ThreadAffinity::apply(ThreadAffinity::parseCores(conversionCores), conversionPriority));
+		}
+
+		auto acquisitionCoresList = config.getString("system/Affinity/AcquisitionCores");
+		auto acquisitionPrio      = config.getInt("system/Affinity/AcquisitionPriority");
+		settings                  = acquisitionCoresList + "/" + std::to_string(acquisitionPrio);
+
+		if (settings != acquisitionSettings) {
+			acquisitionSettings = settings;
+
+			std::scoped_lock lock(affinityLock);
+
+			acquisitionCores    = ThreadAffinity::parseCores(acquisitionCoresList);
+			acquisitionPriority = acquisitionPrio;
+			acquisitionPending.store(true, std::memory_order_release);
+		}
+	}
+
+	void publishAcquisitionAffinity() {
+		if (acquisitionReportReady.exchange(false, std::memory_order_acq_rel)) {
+			std::scoped_lock lock(affinityLock);
+
+			moduleNode.getRelativeNode("system/Affinity/")
+				.updateReadOnly<dv::CfgType::STRING>("AcquisitionApplied", acquisitionReport);
+		}
+	}
+
+	static void moduleShutdownNotify(void *p) {
+		auto module = static_cast<davis *>(p);
+
+		if (module->config.getBool("reconnect/Enable")) {
+			// Let the mainloop thread reopen the device.
+			module->deviceLost.store(true, std::memory_order_release);
+			return;
+		}
+
+		// Runs on the libcaer acquisition thread.
+		dv::LoggerInternal::AsyncLog::instance().log(
+			module->logBlock, dv::logLevel::WARNING, "Device data acquisition ended, stopping module.");
+
+		// Ensure parent also shuts down (on disconnected device for example).
+		module->moduleNode.putBool("running", false);
+	}
+
+	void updateTimestampOffset() {
+		struct timespec tsNow;
+		portable_clock_gettime_realtime(&tsNow);
+
+		int64_t tsNowOffset
+			= static_cast<int64_t>(tsNow.tv_sec * 1000000LL) + static_cast<int64_t>(tsNow.tv_nsec / 1000LL);
+
+		tsOffset = tsNowOffset;
+
+		moduleNode.getRelativeNode("sourceInfo/").updateReadOnly<dv::CfgType::LONG>("tsOffset", tsNowOffset);
+
+		moduleNode.getRelativeNode("outputs/events/info/").updateReadOnly<dv::CfgType::LONG>("tsOffset", tsNowOffset);
+
+		moduleNode.getRelativeNode("outputs/frames/info/").updateReadOnly<dv::CfgType::LONG>("tsOffset", tsNowOffset);
+
+		moduleNode.getRelativeNode("outputs/triggers/info/")
+			.updateReadOnly<dv::CfgType::LONG>("tsOffset", tsNowOffset);
+
+		moduleNode.getRelativeNode("outputs/imu/info/").updateReadOnly<dv::CfgType::LONG>("tsOffset", tsNowOffset);
+
+		// New timebase, the previous clock mapping doesn't apply anymore.
+		clockDrift.reset();
+		lastDeviceTimestamp = INT64_MAX;
+	}
+
+	void updateClockDrift(int64_t hostTime) {
+		if (replay) {
+			// Replayed arrival times are not the device's.
+			return;
+		}
+
+		clockDrift.setHorizon(config.getInt("clock/Horizon"));
+
+		if (!clockDrift.addSample(lastDeviceTimestamp, hostTime)) {
+			return;
+		}
+
+		auto estimate  = clockDrift.estimate();
+		auto clockNode = moduleNode.getRelativeNode("clock/");
+
+		clockNode.updateReadOnly<dv::CfgType::LONG>("offset", estimate.offset);
+		clockNode.updateReadOnly<dv::CfgType::DOUBLE>("skew", estimate.skew);
+		clockNode.updateReadOnly<dv::CfgType::DOUBLE>("confidence", estimate.confidence);
+	}
+
+	static int64_t realTimeClock() {
+		struct timespec tsNow;
+		portable_clock_gettime_realtime(&tsNow);
+
+		return (static_cast<int64_t>(tsNow.tv_sec * 1000000LL) + static_cast<int64_t>(tsNow.tv_nsec / 1000LL));
+	}
+
+	static size_t latencyIndex(int16_t eventType) {
+		switch (eventType) {
+			case FRAME_EVENT:
+				return (1);
+
+			case SPECIAL_EVENT:
+				return (2);
+
+			case IMU6_EVENT:
+				return (3);
+
+			case POLARITY_EVENT:
+			default:
+				return (0);
+		}
+	}
+
+	void convertPacket(
+		caerEventPacketHeaderConst packet, int64_t dataGetTime, int32_t begin = 0, int32_t end = INT32_MAX) {
+		struct dvConvertTimings timings = {0, 0, 0};
+
+		auto conversionStart = dvConvertHostClock();
+
+		dvConvertToAedat4Range(packet, begin, end, moduleData, &timings, conversionOptions);
+
+		if (timings.committed == 0) {
+			// Nothing was sent out.
+			return;
+		}
+
+		int64_t realTimeNow = realTimeClock();
+
+		auto &outputLatency = latency[latencyIndex(caerEventPacketHeaderGetEventType(packet))];
+
+		outputLatency.age.record(realTimeNow - (tsOffset + timings.newestTimestamp));
+		outputLatency.pipeline.record(timings.committed - dataGetTime);
+		outputLatency.conversion.record(timings.converted - conversionStart);
+	}
+
+	void publishLatency() {
+		auto now = std::chrono::steady_clock::now();
+
+		if ((now - latencyLastPublish) < std::chrono::seconds(1)) {
+			return;
+		}
+
+		latencyLastPublish = now;
+
+		for (size_t i = 0; i < latencyOutputs.size(); i++) {
+			latency[i].publish(moduleNode.getRelativeNode("latency/" + std::string(latencyOutputs[i]) + "/"));
+		}
+	}
+
+	/**
+	 * Handle a container holding a TIMESTAMP_RESET. Other packets in it are split
+	 * where their timestamps go back: before that they belong to the old
+	 * timebase (sent out before the offset changes, or dropped / pre-sync
+	 * buffered if not yet initialized), after it to the new one.
+	 */
+	void synchronize(const libcaer::events::EventPacketContainer &data, int64_t dataGetTime) {
+		bool wasInitialized = config.getBool("initialized");
+
+		std::array<int32_t, RawCapture::MAX_PACKET_TYPES> splits{};
+
+		for (auto type : {POLARITY_EVENT, FRAME_EVENT, IMU6_EVENT}) {
+			if (auto packet = data.getEventPacket(type)) {
+				splits[type] = TimestampReset::split(packet->getHeaderPointer(), lastDeviceTimestamp);
+			}
+		}
+
+		if (!wasInitialized && config.getBool("preSync/Enable")) {
+			bufferPreSync(data, splits);
+		}
+
+		auto special    = data.getEventPacket(SPECIAL_EVENT)->getHeaderPointer();
+		auto resetIndex = TimestampReset::find(special);
+
+		// Last device timestamp of the old timebase, pre-sync data is re-based onto it.
+		int64_t resetTimestamp = (lastDeviceTimestamp == INT64_MAX) ? (INT64_MIN) : (lastDeviceTimestamp);
+
+		resetTimestamp = std::max(resetTimestamp, TimestampReset::newest(special, resetIndex));
+
+		for (auto type : {POLARITY_EVENT, FRAME_EVENT, IMU6_EVENT}) {
+			if (auto packet = data.getEventPacket(type)) {
+				resetTimestamp
+					= std::max(resetTimestamp, TimestampReset::newest(packet->getHeaderPointer(), splits[type]));
+			}
+		}
+
+		// Everything before the reset still belongs to the old offset: send it out
+		// first, as its own packets, so timestamps never go back within one.
+		convertPacket(special, dataGetTime, 0, resetIndex);
+
+		if (wasInitialized) {
+			for (auto type : {POLARITY_EVENT, FRAME_EVENT, IMU6_EVENT}) {
+				if (auto packet = data.getEventPacket(type)) {
+					convertPacket(packet->getHeaderPointer(), dataGetTime, 0, splits[type]);
+				}
+			}
+		}
+
+		config.setBool("initialized", true);
+
+		// Update master/slave information.
+		if (device) {
+			auto devInfo = device->infoGet();
+
+			auto sourceInfoNode = moduleNode.getRelativeNode("sourceInfo/");
+			sourceInfoNode.updateReadOnly<dv::CfgType::BOOL>("deviceIsMaster", devInfo.deviceIsMaster);
+		}
+
+		// Reset real-time timestamp offset.
+		updateTimestampOffset();
+
+		if (!wasInitialized && config.getBool("preSync/Enable")) {
+			// Data from just before the sync, ahead of everything after it.
+			preSync.flush(moduleData, static_cast<int64_t>(config.getInt("preSync/Duration")) * 1000, resetTimestamp,
+				conversionOptions.frameStatistics);
+		}
+
+		convertPacket(special, dataGetTime, resetIndex);
+
+		for (auto type : {POLARITY_EVENT, FRAME_EVENT, IMU6_EVENT}) {
+			if (auto packet = data.getEventPacket(type)) {
+				// Before the split: sent out above, or pre-sync buffered / dropped if not yet initialized.
+				convertPacket(packet->getHeaderPointer(), dataGetTime, splits[type]);
+			}
+		}
+	}
 
-		moduleNode.getRelativeNode("outputs/events/info/")
-			.create<dv::CfgType::LONG>("tsOffset", tsNowOffset, {0, INT64_MAX},
-				dv::CfgFlags::READ_ONLY | dv::CfgFlags::NO_EXPORT,
-				"Time offset of data stream starting point to Unix time in µs.");
+	bool updateLastDeviceTimestamp(const libcaer::events::EventPacketContainer &data) {
+		int64_t newest = INT64_MIN;
 
-		moduleNode.getRelativeNode("outputs/frames/info/")
-			.create<dv::CfgType::LONG>("tsOffset", tsNowOffset, {0, INT64_MAX},
-				dv::CfgFlags::READ_ONLY | dv::CfgFlags::NO_EXPORT,
-				"Time offset of data stream starting point to Unix time in µs.");
+		for (auto type : {POLARITY_EVENT, FRAME_EVENT, IMU6_EVENT}) {
+			if (auto packet = data.getEventPacket(type)) {
+				newest = std::max(newest, TimestampReset::newest(packet->getHeaderPointer()));
+			}
+		}
 
-		moduleNode.getRelativeNode("outputs/triggers/info/")
-			.create<dv::CfgType::LONG>("tsOffset", tsNowOffset, {0, INT64_MAX},
-				dv::CfgFlags::READ_ONLY | dv::CfgFlags::NO_EXPORT,
-				"Time offset of data stream starting point to Unix time in µs.");
+		if (newest == INT64_MIN) {
+			return (false);
+		}
 
-		moduleNode.getRelativeNode("outputs/imu/info/")
-			.create<dv::CfgType::LONG>("tsOffset", tsNowOffset, {0, INT64_MAX},
-				dv::CfgFlags::READ_ONLY | dv::CfgFlags::NO_EXPORT,
-				"Time offset of data stream starting point to Unix time in µs.");
+		lastDeviceTimestamp = newest;
 
-		// Start data acquisition.
-		device.dataStart(nullptr, nullptr, nullptr, &moduleShutdownNotify, moduleData->moduleNode);
+		return (true);
+	}
 
-		// Send all configuration to the device.
-		sendDefaultConfiguration(&devInfo);
+	void bufferPreSync(const libcaer::events::EventPacketContainer &data,
+		const std::array<int32_t, RawCapture::MAX_PACKET_TYPES> &ends = {INT32_MAX, INT32_MAX, INT32_MAX, INT32_MAX}) {
+		// Only allocates when the capacities change.
+		preSync.configure(static_cast<size_t>(config.getInt("preSync/MaxEvents")),
+			static_cast<size_t>(config.getInt("preSync/MaxFrames")),
+			static_cast<size_t>(config.getInt("preSync/MaxIMUSamples")), preSyncFramePixels);
 
-		// Add config listeners last, to avoid having them dangling if Init doesn't succeed.
-		moduleNode.getRelativeNode("multiplexer/").addAttributeListener(&device, &multiplexerConfigListener);
+		if (auto polarity = data.getEventPacket(POLARITY_EVENT)) {
+			preSync.addPolarity(polarity->getHeaderPointer(), 0, ends[POLARITY_EVENT], conversionOptions.eventROI);
+		}
 
-		moduleNode.getRelativeNode("dvs/").addAttributeListener(&device, &dvsConfigListener);
+		if (auto frame = data.getEventPacket(FRAME_EVENT)) {
+			preSync.addFrames(frame->getHeaderPointer(), 0, ends[FRAME_EVENT], conversionOptions);
+		}
 
-		for (auto &dvsFilter : moduleNode.getRelativeNode("dvs/").getChildren()) {
-			dvsFilter.addAttributeListener(&device, &dvsConfigListener);
+		if (auto imu = data.getEventPacket(IMU6_EVENT)) {
+			preSync.addIMU6(imu->getHeaderPointer(), 0, ends[IMU6_EVENT]);
 		}
+	}
+
+	void updateRecorder() {
+		if (config.getBool("recorder/Enable") != static_cast<bool>(recorder)) {
+			if (recorder) {
+				// Waits for the queued containers to be written out.
+				publishRecorderStatistics();
+
+				std::unique_ptr<RawRecorder> stopped;
 
-		moduleNode.getRelativeNode("aps/").addAttributeListener(&device, &apsConfigListener);
+				{
+					std::scoped_lock lock(drainLock);
+					stopped = std::move(recorder);
+				}
 
-		moduleNode.getRelativeNode("imu/").addAttributeListener(&device, &imuConfigListener);
+				// Outside the lock, acquisition goes on meanwhile.
+				stopped.reset();
 
-		moduleNode.getRelativeNode("externalInput/").addAttributeListener(&device, &externalInputConfigListener);
+				log.info << "Raw recording stopped." << dv::logEnd;
+			}
+			else {
+				auto file = config.getString("recorder/File");
 
-		moduleNode.getRelativeNode("usb/").addAttributeListener(&device, &usbConfigListener);
+				if (file.empty()) {
+					log.warning << "No raw recording file set, not recording." << dv::logEnd;
+					config.setBool("recorder/Enable", false);
+					return;
+				}
 
-		moduleNode.getRelativeNode("system/").addAttributeListener(&device, &systemConfigListener);
+				auto started = std::make_unique<RawRecorder>(file,
+					static_cast<size_t>(config.getInt("recorder/FileSize")) * 1024 * 1024,
+					static_cast<size_t>(config.getInt("recorder/FilesNumber")), recorderFileHeader,
+					static_cast<size_t>(config.getInt("recorder/QueueSize")));
 
-		moduleNode.addAttributeListener(&device, &logLevelListener);
+				{
+					std::scoped_lock lock(drainLock);
+					recorder = std::move(started);
+				}
 
-		moduleNode.addAttributeListener(&device, &modeListener);
+				log.info << "Raw recording started." << dv::logEnd;
+			}
+		}
 
-		auto chipNode = moduleNode.getRelativeNode(chipIDToName(devInfo.chipID, true));
+		if (!recorder) {
+			return;
+		}
 
-		chipNode.getRelativeNode("chip/").addAttributeListener(&device, &chipConfigListener);
+		auto now = std::chrono::steady_clock::now();
 
-		auto biasNode = chipNode.getRelativeNode("bias/");
+		if ((now - recorderLastPublish) < std::chrono::seconds(1)) {
+			return;
+		}
 
-		for (auto &singleBias : biasNode.getChildren()) {
-			singleBias.addAttributeListener(&device, &biasConfigListener);
+		recorderLastPublish = now;
+
+		publishRecorderStatistics();
+
+		if (recorder->failed()) {
+			log.error << "Raw recording failed (file could not be created, or too small), stopping it."
+					  << dv::logEnd;
+			config.setBool("recorder/Enable", false);
 		}
 	}
 
-	~davis() override {
-		auto devInfo = device.infoGet();
+	void publishRecorderStatistics() {
+		auto statNode = moduleNode.getRelativeNode("statistics/");
 
-		// Remove listener, which can reference invalid memory in userData.
-		moduleNode.getRelativeNode("multiplexer/").removeAttributeListener(&device, &multiplexerConfigListener);
+		statNode.updateReadOnly<dv::CfgType::LONG>("recorderDroppedContainers", recorder->dropped());
+		statNode.updateReadOnly<dv::CfgType::LONG>("recorderBytesWritten", recorder->written());
+	}
 
-		moduleNode.getRelativeNode("dvs/").removeAttributeListener(&device, &dvsConfigListener);
+	void updateRateGovernorSettings() {
+		rateGovernorDevInfo    = device->infoGet();
+		rateGovernorEnable     = config.getBool("rateGovernor/Enable");
+		rateGovernorTargetRate = config.getInt("rateGovernor/TargetRate") * 1000.0;
+		rateGovernorConfigured = configuredFilterSettings(&rateGovernorDevInfo);
+	}
 
-		for (auto &dvsFilter : moduleNode.getRelativeNode("dvs/").getChildren()) {
-			dvsFilter.removeAttributeListener(&device, &dvsConfigListener);
+	void updateRateGovernor(const libcaer::events::EventPacketContainer &data) {
+		if (replay) {
+			// No filters to drive.
+			return;
 		}
 
-		moduleNode.getRelativeNode("aps/").removeAttributeListener(&device, &apsConfigListener);
-
-		moduleNode.getRelativeNode("imu/").removeAttributeListener(&device, &imuConfigListener);
+		const auto &devInfo = rateGovernorDevInfo;
 
-		moduleNode.getRelativeNode("externalInput/").removeAttributeListener(&device, &externalInputConfigListener);
+		if (!rateGovernorEnable) {
+			if (rateGovernorActive) {
+				// Back to exactly what is configured now, it may have changed together with Enable.
+				rateGovernorActive = false;
+				sendFilterSettings(&devInfo, rateGovernorConfigured);
 
-		moduleNode.getRelativeNode("usb/").removeAttributeListener(&device, &usbConfigListener);
+				moduleNode.getRelativeNode("rateGovernor/").updateReadOnly<dv::CfgType::DOUBLE>("Strength", 0.0);
+			}
 
-		moduleNode.getRelativeNode("system/").removeAttributeListener(&device, &systemConfigListener);
+			return;
+		}
 
-		moduleNode.removeAttributeListener(&device, &logLevelListener);
+		auto now        = std::chrono::steady_clock::now();
+		auto configured = rateGovernorConfigured;
 
-		moduleNode.removeAttributeListener(&device, &modeListener);
+		if (!rateGovernorActive || (configured != rateGovernor.getConfigured())) {
+			// Started, or the user changed a filter setting: start over from the configuration.
+			if (rateGovernorActive) {
+				sendFilterSettings(&devInfo, configured);
+			}
 
-		auto chipNode = moduleNode.getRelativeNode(chipIDToName(devInfo.chipID, true));
+			rateGovernor.reset(configured, devInfo.dvsHasBackgroundActivityFilter, devInfo.dvsHasSkipFilter);
+			rateGovernorActive      = true;
+			rateGovernorWindowStart = now;
+		}
 
-		chipNode.getRelativeNode("chip/").removeAttributeListener(&device, &chipConfigListener);
+		if (auto polarity = data.getEventPacket(POLARITY_EVENT)) {
+			rateGovernor.addEvents(polarity->getEventValid());
+		}
 
-		auto biasNode = chipNode.getRelativeNode("bias/");
+		auto windowDuration
+			= std::chrono::duration_cast<std::chrono::microseconds>(now - rateGovernorWindowStart).count();
 
-		for (auto &singleBias : biasNode.getChildren()) {
-			singleBias.removeAttributeListener(&device, &biasConfigListener);
+		if (windowDuration < 200000) {
+			return;
 		}
 
-		// Stop data acquisition.
-		device.dataStop();
+		rateGovernorWindowStart = now;
 
-		// Ensure Exposure value is coherent with libcaer.
-		moduleNode.getRelativeNode("aps/").attributeUpdaterRemoveAll();
-		moduleNode.getRelativeNode("aps/").putInt(
-			"Exposure", apsExposureUpdater(&device, "Exposure", DVCFG_TYPE_INT).iint);
+		RateGovernor::Settings settings;
 
-		// Remove statistics read modifiers.
-		if (moduleNode.existsRelativeNode("statistics/")) {
-			moduleNode.getRelativeNode("statistics/").attributeUpdaterRemoveAll();
+		if (rateGovernor.update(windowDuration, rateGovernorTargetRate, settings)) {
+			sendFilterSettings(&devInfo, settings);
 		}
 
-		// Clear sourceInfo node.
-		auto sourceInfoNode = moduleNode.getRelativeNode("sourceInfo/");
-		sourceInfoNode.removeAllAttributes();
+		auto rateGovernorNode = moduleNode.getRelativeNode("rateGovernor/");
+		rateGovernorNode.updateReadOnly<dv::CfgType::DOUBLE>("Strength", rateGovernor.getStrength());
+		rateGovernorNode.updateReadOnly<dv::CfgType::DOUBLE>("Rate", rateGovernor.getRate() / 1000000.0);
 	}
 
-	void run() override {
+	RateGovernor::Settings configuredFilterSettings(const struct caer_davis_info *devInfo) {
+		RateGovernor::Settings settings = {false, 0, false, 0, false, 1};
 
-		if (config.getBool("resetInitialization")) {
-			config.setBool("resetInitialization", false);
-			config.setBool("initialized", false);
+		if (devInfo->dvsHasBackgroundActivityFilter) {
+			settings.noiseEnable = config.getBool("dvs/NoiseFilter/Enable");
+			settings.noiseTime   = config.getInt("dvs/NoiseFilter/Time");
+			settings.rateEnable  = config.getBool("dvs/RateFilter/Enable");
+			settings.rateTime    = config.getInt("dvs/RateFilter/Time");
 		}
 
-		auto data = device.dataGet();
+		if (devInfo->dvsHasSkipFilter) {
+			settings.skipEnable = config.getBool("dvs/SkipFilter/Enable");
+			settings.skipEvery  = config.getInt("dvs/SkipFilter/SkipEveryEvents");
+		}
 
-		if (!data || data->empty()) {
+		return (settings);
+	}
+
+	void sendFilterSettings(const struct caer_davis_info *devInfo, const RateGovernor::Settings &settings) {
+		if (devInfo->dvsHasBackgroundActivityFilter) {
+			device->configSet(DAVIS_CONFIG_DVS, DAVIS_CONFIG_DVS_FILTER_BACKGROUND_ACTIVITY, settings.noiseEnable);
+			device->configSet(DAVIS_CONFIG_DVS, DAVIS_CONFIG_DVS_FILTER_BACKGROUND_ACTIVITY_TIME,
+				static_cast<uint32_t>(settings.noiseTime));
+			device->configSet(DAVIS_CONFIG_DVS, DAVIS_CONFIG_DVS_FILTER_REFRACTORY_PERIOD, settings.rateEnable);
+			device->configSet(DAVIS_CONFIG_DVS, DAVIS_CONFIG_DVS_FILTER_REFRACTORY_PERIOD_TIME,
+				static_cast<uint32_t>(settings.rateTime));
+		}
+
+		if (devInfo->dvsHasSkipFilter) {
+			device->configSet(DAVIS_CONFIG_DVS, DAVIS_CONFIG_DVS_FILTER_SKIP_EVENTS, settings.skipEnable);
+			device->configSet(DAVIS_CONFIG_DVS, DAVIS_CONFIG_DVS_FILTER_SKIP_EVENTS_EVERY,
+				static_cast<uint32_t>(settings.skipEvery));
+		}
+	}
+
+	void controlContainers(const libcaer::events::EventPacketContainer &data, int64_t processingTime) {
+		if (!config.getBool("system/AdaptiveContainers/Enable")) {
+			containerController.reset();
+			containerWindowStart = std::chrono::steady_clock::time_point{};
 			return;
 		}
 
-		if (data->getEventPacket(SPECIAL_EVENT)) {
-			std::shared_ptr<const libcaer::events::SpecialEventPacket> special
-				= std::static_pointer_cast<libcaer::events::SpecialEventPacket>(data->getEventPacket(SPECIAL_EVENT));
+		auto now = std::chrono::steady_clock::now();
 
-			if (special->getEventNumber() == 1 && (*special)[0].getType() == TIMESTAMP_RESET) {
+		if (containerWindowStart == std::chrono::steady_clock::time_point{}) {
+			containerWindowStart = now;
+		}
+
+		auto polarity = data.getEventPacket(POLARITY_EVENT);
+
+		containerController.addContainer((polarity) ? (polarity->getEventValid()) : (0), processingTime);
+
+		auto windowDuration
+			= std::chrono::duration_cast<std::chrono::microseconds>(now - containerWindowStart).count();
 
-				config.setBool("initialized", true);
+		if (windowDuration < 500000) {
+			return;
+		}
 
-				// Update master/slave information.
-				auto devInfo = device.infoGet();
+		containerWindowStart = now;
+
+		ContainerController::Bounds bounds = {
+			.targetLatency = config.getInt("system/AdaptiveContainers/TargetLatency"),
+			.minInterval   = config.getInt("system/AdaptiveContainers/MinInterval"),
+		};
 
-				auto sourceInfoNode = moduleNode.getRelativeNode("sourceInfo/");
-				sourceInfoNode.updateReadOnly<dv::CfgType::BOOL>("deviceIsMaster", devInfo.deviceIsMaster);
+		ContainerController::Result result;
 
-				// Reset real-time timestamp offset.
-				struct timespec tsNow;
-				portable_clock_gettime_realtime(&tsNow);
+		if (containerController.update(
+				windowDuration, bounds, config.getInt("system/PacketContainerInterval"), result)) {
+			// Goes to the device through systemConfigListener.
+			config.setInt("system/PacketContainerInterval", result.interval);
+			config.setInt("system/PacketContainerMaxPacketSize", result.maxPacketSize);
+		}
+	}
 
-				int64_t tsNowOffset
-					= static_cast<int64_t>(tsNow.tv_sec * 1000000LL) + static_cast<int64_t>(tsNow.tv_nsec / 1000LL);
+	void reconnectDevice() {
+		auto now     = std::chrono::steady_clock::now();
+		auto devInfo = device->infoGet();
 
-				sourceInfoNode.updateReadOnly<dv::CfgType::LONG>("tsOffset", tsNowOffset);
+		if (deviceLostTime == std::chrono::steady_clock::time_point{}) {
+			// First time we notice: detach listeners from the dead handle.
+			deviceLostTime = now;
 
-				moduleNode.getRelativeNode("outputs/events/info/")
-					.updateReadOnly<dv::CfgType::LONG>("tsOffset", tsNowOffset);
+			removeConfigListeners(&devInfo);
+			moduleNode.getRelativeNode("aps/").attributeUpdaterRemoveAll();
 
-				moduleNode.getRelativeNode("outputs/frames/info/")
-					.updateReadOnly<dv::CfgType::LONG>("tsOffset", tsNowOffset);
+			statistics.stop();
 
-				moduleNode.getRelativeNode("outputs/triggers/info/")
-					.updateReadOnly<dv::CfgType::LONG>("tsOffset", tsNowOffset);
+			exchange.stop();
 
-				moduleNode.getRelativeNode("outputs/imu/info/")
-					.updateReadOnly<dv::CfgType::LONG>("tsOffset", tsNowOffset);
+			try {
+				device->dataStop();
+			}
+			catch (const std::runtime_error &) {
+				// Device is gone, stopping may fail.
 			}
 
-			dvConvertToAedat4(special->getHeaderPointer(), moduleData);
+			log.warning << "Device " << deviceSerialNumber << " disconnected, trying to reconnect." << dv::logEnd;
 		}
 
-		if (data->size() == 1) {
+		auto timeout = std::chrono::seconds(config.getInt("reconnect/Timeout"));
+
+		if ((timeout.count() > 0) && ((now - deviceLostTime) > timeout)) {
+			log.error << "Device " << deviceSerialNumber << " did not come back, giving up." << dv::logEnd;
+			moduleNode.putBool("running", false);
 			return;
 		}
 
-		if (!config.getBool("initialized")) {
+		auto retryInterval = std::chrono::milliseconds(config.getInt("reconnect/RetryInterval"));
+
+		if ((now - reconnectLastAttempt) < retryInterval) {
+			// Don't spin the mainloop while waiting for the next attempt.
+			std::this_thread::sleep_for(std::min(
+				std::chrono::duration_cast<std::chrono::milliseconds>(retryInterval - (now - reconnectLastAttempt)),
+				std::chrono::milliseconds(10)));
 			return;
 		}
 
-		if (data->getEventPacket(POLARITY_EVENT)) {
-			dvConvertToAedat4(data->getEventPacket(POLARITY_EVENT)->getHeaderPointer(), moduleData);
-		}
+		reconnectLastAttempt = now;
 
-		if (data->getEventPacket(FRAME_EVENT)) {
-			dvConvertToAedat4(data->getEventPacket(FRAME_EVENT)->getHeaderPointer(), moduleData);
+		try {
+			device = std::make_unique<libcaer::devices::davis>(0, 0, 0, deviceSerialNumber);
+		}
+		catch (const std::runtime_error &) {
+			// Not back yet, retry later.
+			return;
 		}
 
-		if (data->getEventPacket(IMU6_EVENT)) {
-			dvConvertToAedat4(data->getEventPacket(IMU6_EVENT)->getHeaderPointer(), moduleData);
+		auto newInfo = device->infoGet();
+
+		if (newInfo.chipID != devInfo.chipID) {
+			log.error << "Reconnected device " << deviceSerialNumber << " reports a different chip, giving up."
+					  << dv::logEnd;
+			moduleNode.putBool("running", false);
+			return;
 		}
-	}
 
-private:
-	static void moduleShutdownNotify(void *p) {
-		dv::Cfg::Node moduleNode = static_cast<dvConfigNode>(p);
+		auto sourceInfoNode = moduleNode.getRelativeNode("sourceInfo/");
+		sourceInfoNode.updateReadOnly<dv::CfgType::INT>("usbBusNumber", newInfo.deviceUSBBusNumber);
+		sourceInfoNode.updateReadOnly<dv::CfgType::INT>("usbDeviceAddress", newInfo.deviceUSBDeviceAddress);
 
-		// Ensure parent also shuts down (on disconnected device for example).
-		moduleNode.putBool("running", false);
+		// Same setup as on module init, the configuration tree holds the last state.
+		device->configSet(CAER_HOST_CONFIG_LOG, CAER_HOST_CONFIG_LOG_LEVEL,
+			static_cast<uint32_t>(dv::LoggerInternal::logLevelNameToInteger(config.getString("logLevel"))));
+
+		device->configSet(CAER_HOST_CONFIG_DATAEXCHANGE, CAER_HOST_CONFIG_DATAEXCHANGE_BLOCKING, false);
+		device->configSet(CAER_HOST_CONFIG_DATAEXCHANGE, CAER_HOST_CONFIG_DATAEXCHANGE_START_PRODUCERS, false);
+		device->configSet(CAER_HOST_CONFIG_DATAEXCHANGE, CAER_HOST_CONFIG_DATAEXCHANGE_STOP_PRODUCERS, true);
+
+		deviceLost.store(false, std::memory_order_release);
+
+		exchange.start();
+
+		device->dataStart(&dataNotifyIncrease, nullptr, this, &moduleShutdownNotify, this);
+
+		// New acquisition thread, place it again.
+		acquisitionPending.store(true, std::memory_order_release);
+
+		sendDefaultConfiguration(&newInfo);
+
+		addConfigListeners(&newInfo);
+
+		// The new device got the configured filter settings, govern from there.
+		rateGovernorActive  = false;
+		rateGovernorDevInfo = newInfo;
+
+		statistics.start(device.get(), moduleNode.getRelativeNode("system/"));
+
+		// Device timestamps restarted from zero: wait for a new sync pulse.
+		config.setBool("initialized", false);
+		updateTimestampOffset();
+
+		auto downtime
+			= std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - deviceLostTime)
+				  .count();
+
+		reconnectCount++;
+		reconnectTotalDowntime += downtime;
+		deviceLostTime = std::chrono::steady_clock::time_point{};
+
+		auto statNode = moduleNode.getRelativeNode("statistics/");
+		statNode.updateReadOnly<dv::CfgType::LONG>("reconnectCount", reconnectCount);
+		statNode.updateReadOnly<dv::CfgType::LONG>("reconnectLastDowntime", downtime);
+		statNode.updateReadOnly<dv::CfgType::LONG>("reconnectTotalDowntime", reconnectTotalDowntime);
+
+		log.info << "Device " << deviceSerialNumber << " reconnected after " << downtime << " ms." << dv::logEnd;
 	}
 
 	static inline std::string chipIDToName(int16_t chipID, bool withEndSlash) {
@@ -442,6 +1443,74 @@ private:
 		externalInputConfigSend(devInfo);
 	}
 
+	void addConfigListeners(const struct caer_davis_info *devInfo) {
+		moduleNode.getRelativeNode("multiplexer/").addAttributeListener(device.get(), &multiplexerConfigListener);
+
+		moduleNode.getRelativeNode("dvs/").addAttributeListener(device.get(), &dvsConfigListener);
+
+		for (auto &dvsFilter : moduleNode.getRelativeNode("dvs/").getChildren()) {
+			dvsFilter.addAttributeListener(device.get(), &dvsConfigListener);
+		}
+
+		moduleNode.getRelativeNode("aps/").addAttributeListener(device.get(), &apsConfigListener);
+
+		moduleNode.getRelativeNode("imu/").addAttributeListener(device.get(), &imuConfigListener);
+
+		moduleNode.getRelativeNode("externalInput/").addAttributeListener(device.get(), &externalInputConfigListener);
+
+		moduleNode.getRelativeNode("usb/").addAttributeListener(device.get(), &usbConfigListener);
+
+		moduleNode.getRelativeNode("system/").addAttributeListener(device.get(), &systemConfigListener);
+
+		moduleNode.addAttributeListener(device.get(), &logLevelListener);
+
+		moduleNode.addAttributeListener(device.get(), &modeListener);
+
+		auto chipNode = moduleNode.getRelativeNode(chipIDToName(devInfo->chipID, true));
+
+		chipNode.getRelativeNode("chip/").addAttributeListener(device.get(), &chipConfigListener);
+
+		auto biasNode = chipNode.getRelativeNode("bias/");
+
+		for (auto &singleBias : biasNode.getChildren()) {
+			singleBias.addAttributeListener(device.get(), &biasConfigListener);
+		}
+	}
+
+	void removeConfigListeners(const struct caer_davis_info *devInfo) {
+		moduleNode.getRelativeNode("multiplexer/").removeAttributeListener(device.get(), &multiplexerConfigListener);
+
+		moduleNode.getRelativeNode("dvs/").removeAttributeListener(device.get(), &dvsConfigListener);
+
+		for (auto &dvsFilter : moduleNode.getRelativeNode("dvs/").getChildren()) {
+			dvsFilter.removeAttributeListener(device.get(), &dvsConfigListener);
+		}
+
+		moduleNode.getRelativeNode("aps/").removeAttributeListener(device.get(), &apsConfigListener);
+
+		moduleNode.getRelativeNode("imu/").removeAttributeListener(device.get(), &imuConfigListener);
+
+		moduleNode.getRelativeNode("externalInput/").removeAttributeListener(device.get(), &externalInputConfigListener);
+
+		moduleNode.getRelativeNode("usb/").removeAttributeListener(device.get(), &usbConfigListener);
+
+		moduleNode.getRelativeNode("system/").removeAttributeListener(device.get(), &systemConfigListener);
+
+		moduleNode.removeAttributeListener(device.get(), &logLevelListener);
+
+		moduleNode.removeAttributeListener(device.get(), &modeListener);
+
+		auto chipNode = moduleNode.getRelativeNode(chipIDToName(devInfo->chipID, true));
+
+		chipNode.getRelativeNode("chip/").removeAttributeListener(device.get(), &chipConfigListener);
+
+		auto biasNode = chipNode.getRelativeNode("bias/");
+
+		for (auto &singleBias : biasNode.getChildren()) {
+			singleBias.removeAttributeListener(device.get(), &biasConfigListener);
+		}
+	}
+
 	void biasConfigCreateDynamic(const struct caer_davis_info *devInfo) {
 		auto biasPath = chipIDToName(devInfo->chipID, true) + "bias/";
 
@@ -576,184 +1645,184 @@ private:
 
 		// All chips of a kind have the same bias address for the same bias!
 		if (IS_DAVIS240(devInfo->chipID)) {
-			device.configSet(
+			device->configSet(
 				DAVIS_CONFIG_BIAS, DAVIS240_CONFIG_BIAS_DIFFBN, generateCoarseFineBias(biasPath + "DiffBn"));
-			device.configSet(DAVIS_CONFIG_BIAS, DAVIS240_CONFIG_BIAS_ONBN, generateCoarseFineBias(biasPath + "OnBn"));
-			device.configSet(DAVIS_CONFIG_BIAS, DAVIS240_CONFIG_BIAS_OFFBN, generateCoarseFineBias(biasPath + "OffBn"));
-			device.configSet(
+			device->configSet(DAVIS_CONFIG_BIAS, DAVIS240_CONFIG_BIAS_ONBN, generateCoarseFineBias(biasPath + "OnBn"));
+			device->configSet(DAVIS_CONFIG_BIAS, DAVIS240_CONFIG_BIAS_OFFBN, generateCoarseFineBias(biasPath + "OffBn"));
+			device->configSet(
 				DAVIS_CONFIG_BIAS, DAVIS240_CONFIG_BIAS_APSCASEPC, generateCoarseFineBias(biasPath + "ApsCasEpc"));
-			device.configSet(
+			device->configSet(
 				DAVIS_CONFIG_BIAS, DAVIS240_CONFIG_BIAS_DIFFCASBNC, generateCoarseFineBias(biasPath + "DiffCasBnc"));
-			device.configSet(
+			device->configSet(
 				DAVIS_CONFIG_BIAS, DAVIS240_CONFIG_BIAS_APSROSFBN, generateCoarseFineBias(biasPath + "ApsROSFBn"));
-			device.configSet(
+			device->configSet(
 				DAVIS_CONFIG_BIAS, DAVIS240_CONFIG_BIAS_LOCALBUFBN, generateCoarseFineBias(biasPath + "LocalBufBn"));
-			device.configSet(
+			device->configSet(
 				DAVIS_CONFIG_BIAS, DAVIS240_CONFIG_BIAS_PIXINVBN, generateCoarseFineBias(biasPath + "PixInvBn"));
-			device.configSet(DAVIS_CONFIG_BIAS, DAVIS240_CONFIG_BIAS_PRBP, generateCoarseFineBias(biasPath + "PrBp"));
-			device.configSet(
+			device->configSet(DAVIS_CONFIG_BIAS, DAVIS240_CONFIG_BIAS_PRBP, generateCoarseFineBias(biasPath + "PrBp"));
+			device->configSet(
 				DAVIS_CONFIG_BIAS, DAVIS240_CONFIG_BIAS_PRSFBP, generateCoarseFineBias(biasPath + "PrSFBp"));
-			device.configSet(
+			device->configSet(
 				DAVIS_CONFIG_BIAS, DAVIS240_CONFIG_BIAS_REFRBP, generateCoarseFineBias(biasPath + "RefrBp"));
-			device.configSet(
+			device->configSet(
 				DAVIS_CONFIG_BIAS, DAVIS240_CONFIG_BIAS_AEPDBN, generateCoarseFineBias(biasPath + "AEPdBn"));
-			device.configSet(DAVIS_CONFIG_BIAS, DAVIS240_CONFIG_BIAS_LCOLTIMEOUTBN,
+			device->configSet(DAVIS_CONFIG_BIAS, DAVIS240_CONFIG_BIAS_LCOLTIMEOUTBN,
 				generateCoarseFineBias(biasPath + "LcolTimeoutBn"));
-			device.configSet(
+			device->configSet(
 				DAVIS_CONFIG_BIAS, DAVIS240_CONFIG_BIAS_AEPUXBP, generateCoarseFineBias(biasPath + "AEPuXBp"));
-			device.configSet(
+			device->configSet(
 				DAVIS_CONFIG_BIAS, DAVIS240_CONFIG_BIAS_AEPUYBP, generateCoarseFineBias(biasPath + "AEPuYBp"));
-			device.configSet(
+			device->configSet(
 				DAVIS_CONFIG_BIAS, DAVIS240_CONFIG_BIAS_IFTHRBN, generateCoarseFineBias(biasPath + "IFThrBn"));
-			device.configSet(
+			device->configSet(
 				DAVIS_CONFIG_BIAS, DAVIS240_CONFIG_BIAS_IFREFRBN, generateCoarseFineBias(biasPath + "IFRefrBn"));
-			device.configSet(
+			device->configSet(
 				DAVIS_CONFIG_BIAS, DAVIS240_CONFIG_BIAS_PADFOLLBN, generateCoarseFineBias(biasPath + "PadFollBn"));
-			device.configSet(DAVIS_CONFIG_BIAS, DAVIS240_CONFIG_BIAS_APSOVERFLOWLEVELBN,
+			device->configSet(DAVIS_CONFIG_BIAS, DAVIS240_CONFIG_BIAS_APSOVERFLOWLEVELBN,
 				generateCoarseFineBias(biasPath + "ApsOverflowLevelBn"));
 
-			device.configSet(
+			device->configSet(
 				DAVIS_CONFIG_BIAS, DAVIS240_CONFIG_BIAS_BIASBUFFER, generateCoarseFineBias(biasPath + "BiasBuffer"));
 
-			device.configSet(DAVIS_CONFIG_BIAS, DAVIS240_CONFIG_BIAS_SSP, generateShiftedSourceBias(biasPath + "SSP"));
-			device.configSet(DAVIS_CONFIG_BIAS, DAVIS240_CONFIG_BIAS_SSN, generateShiftedSourceBias(biasPath + "SSN"));
+			device->configSet(DAVIS_CONFIG_BIAS, DAVIS240_CONFIG_BIAS_SSP, generateShiftedSourceBias(biasPath + "SSP"));
+			device->configSet(DAVIS_CONFIG_BIAS, DAVIS240_CONFIG_BIAS_SSN, generateShiftedSourceBias(biasPath + "SSN"));
 		}
 
 		if (IS_DAVIS128(devInfo->chipID) || IS_DAVIS208(devInfo->chipID) || IS_DAVIS346(devInfo->chipID)
 			|| IS_DAVIS640(devInfo->chipID)) {
-			device.configSet(DAVIS_CONFIG_BIAS, DAVIS128_CONFIG_BIAS_APSOVERFLOWLEVEL,
+			device->configSet(DAVIS_CONFIG_BIAS, DAVIS128_CONFIG_BIAS_APSOVERFLOWLEVEL,
 				generateVDACBias(biasPath + "ApsOverflowLevel"));
-			device.configSet(DAVIS_CONFIG_BIAS, DAVIS128_CONFIG_BIAS_APSCAS, generateVDACBias(biasPath + "ApsCas"));
-			device.configSet(
+			device->configSet(DAVIS_CONFIG_BIAS, DAVIS128_CONFIG_BIAS_APSCAS, generateVDACBias(biasPath + "ApsCas"));
+			device->configSet(
 				DAVIS_CONFIG_BIAS, DAVIS128_CONFIG_BIAS_ADCREFHIGH, generateVDACBias(biasPath + "AdcRefHigh"));
-			device.configSet(
+			device->configSet(
 				DAVIS_CONFIG_BIAS, DAVIS128_CONFIG_BIAS_ADCREFLOW, generateVDACBias(biasPath + "AdcRefLow"));
 
 			if (IS_DAVIS346(devInfo->chipID) || IS_DAVIS640(devInfo->chipID)) {
-				device.configSet(DAVIS_CONFIG_BIAS, DAVIS346_CONFIG_BIAS_ADCTESTVOLTAGE,
+				device->configSet(DAVIS_CONFIG_BIAS, DAVIS346_CONFIG_BIAS_ADCTESTVOLTAGE,
 					generateVDACBias(biasPath + "AdcTestVoltage"));
 			}
 
 			if (IS_DAVIS208(devInfo->chipID)) {
-				device.configSet(DAVIS_CONFIG_BIAS, DAVIS208_CONFIG_BIAS_RESETHIGHPASS,
+				device->configSet(DAVIS_CONFIG_BIAS, DAVIS208_CONFIG_BIAS_RESETHIGHPASS,
 					generateVDACBias(biasPath + "ResetHighPass"));
-				device.configSet(DAVIS_CONFIG_BIAS, DAVIS208_CONFIG_BIAS_REFSS, generateVDACBias(biasPath + "RefSS"));
+				device->configSet(DAVIS_CONFIG_BIAS, DAVIS208_CONFIG_BIAS_REFSS, generateVDACBias(biasPath + "RefSS"));
 
-				device.configSet(
+				device->configSet(
 					DAVIS_CONFIG_BIAS, DAVIS208_CONFIG_BIAS_REGBIASBP, generateCoarseFineBias(biasPath + "RegBiasBp"));
-				device.configSet(
+				device->configSet(
 					DAVIS_CONFIG_BIAS, DAVIS208_CONFIG_BIAS_REFSSBN, generateCoarseFineBias(biasPath + "RefSSBn"));
 			}
 
-			device.configSet(
+			device->configSet(
 				DAVIS_CONFIG_BIAS, DAVIS128_CONFIG_BIAS_LOCALBUFBN, generateCoarseFineBias(biasPath + "LocalBufBn"));
-			device.configSet(
+			device->configSet(
 				DAVIS_CONFIG_BIAS, DAVIS128_CONFIG_BIAS_PADFOLLBN, generateCoarseFineBias(biasPath + "PadFollBn"));
-			device.configSet(
+			device->configSet(
 				DAVIS_CONFIG_BIAS, DAVIS128_CONFIG_BIAS_DIFFBN, generateCoarseFineBias(biasPath + "DiffBn"));
-			device.configSet(DAVIS_CONFIG_BIAS, DAVIS128_CONFIG_BIAS_ONBN, generateCoarseFineBias(biasPath + "OnBn"));
-			device.configSet(DAVIS_CONFIG_BIAS, DAVIS128_CONFIG_BIAS_OFFBN, generateCoarseFineBias(biasPath + "OffBn"));
-			device.configSet(
+			device->configSet(DAVIS_CONFIG_BIAS, DAVIS128_CONFIG_BIAS_ONBN, generateCoarseFineBias(biasPath + "OnBn"));
+			device->configSet(DAVIS_CONFIG_BIAS, DAVIS128_CONFIG_BIAS_OFFBN, generateCoarseFineBias(biasPath + "OffBn"));
+			device->configSet(
 				DAVIS_CONFIG_BIAS, DAVIS128_CONFIG_BIAS_PIXINVBN, generateCoarseFineBias(biasPath + "PixInvBn"));
-			device.configSet(DAVIS_CONFIG_BIAS, DAVIS128_CONFIG_BIAS_PRBP, generateCoarseFineBias(biasPath + "PrBp"));
-			device.configSet(
+			device->configSet(DAVIS_CONFIG_BIAS, DAVIS128_CONFIG_BIAS_PRBP, generateCoarseFineBias(biasPath + "PrBp"));
+			device->configSet(
 				DAVIS_CONFIG_BIAS, DAVIS128_CONFIG_BIAS_PRSFBP, generateCoarseFineBias(biasPath + "PrSFBp"));
-			device.configSet(
+			device->configSet(
 				DAVIS_CONFIG_BIAS, DAVIS128_CONFIG_BIAS_REFRBP, generateCoarseFineBias(biasPath + "RefrBp"));
-			device.configSet(DAVIS_CONFIG_BIAS, DAVIS128_CONFIG_BIAS_READOUTBUFBP,
+			device->configSet(DAVIS_CONFIG_BIAS, DAVIS128_CONFIG_BIAS_READOUTBUFBP,
 				generateCoarseFineBias(biasPath + "ReadoutBufBp"));
-			device.configSet(
+			device->configSet(
 				DAVIS_CONFIG_BIAS, DAVIS128_CONFIG_BIAS_APSROSFBN, generateCoarseFineBias(biasPath + "ApsROSFBn"));
-			device.configSet(
+			device->configSet(
 				DAVIS_CONFIG_BIAS, DAVIS128_CONFIG_BIAS_ADCCOMPBP, generateCoarseFineBias(biasPath + "AdcCompBp"));
-			device.configSet(
+			device->configSet(
 				DAVIS_CONFIG_BIAS, DAVIS128_CONFIG_BIAS_COLSELLOWBN, generateCoarseFineBias(biasPath + "ColSelLowBn"));
-			device.configSet(
+			device->configSet(
 				DAVIS_CONFIG_BIAS, DAVIS128_CONFIG_BIAS_DACBUFBP, generateCoarseFineBias(biasPath + "DACBufBp"));
-			device.configSet(DAVIS_CONFIG_BIAS, DAVIS128_CONFIG_BIAS_LCOLTIMEOUTBN,
+			device->configSet(DAVIS_CONFIG_BIAS, DAVIS128_CONFIG_BIAS_LCOLTIMEOUTBN,
 				generateCoarseFineBias(biasPath + "LcolTimeoutBn"));
-			device.configSet(
+			device->configSet(
 				DAVIS_CONFIG_BIAS, DAVIS128_CONFIG_BIAS_AEPDBN, generateCoarseFineBias(biasPath + "AEPdBn"));
-			device.configSet(
+			device->configSet(
 				DAVIS_CONFIG_BIAS, DAVIS128_CONFIG_BIAS_AEPUXBP, generateCoarseFineBias(biasPath + "AEPuXBp"));
-			device.configSet(
+			device->configSet(
 				DAVIS_CONFIG_BIAS, DAVIS128_CONFIG_BIAS_AEPUYBP, generateCoarseFineBias(biasPath + "AEPuYBp"));
-			device.configSet(
+			device->configSet(
 				DAVIS_CONFIG_BIAS, DAVIS128_CONFIG_BIAS_IFREFRBN, generateCoarseFineBias(biasPath + "IFRefrBn"));
-			device.configSet(
+			device->configSet(
 				DAVIS_CONFIG_BIAS, DAVIS128_CONFIG_BIAS_IFTHRBN, generateCoarseFineBias(biasPath + "IFThrBn"));
 
-			device.configSet(
+			device->configSet(
 				DAVIS_CONFIG_BIAS, DAVIS128_CONFIG_BIAS_BIASBUFFER, generateCoarseFineBias(biasPath + "BiasBuffer"));
 
-			device.configSet(DAVIS_CONFIG_BIAS, DAVIS128_CONFIG_BIAS_SSP, generateShiftedSourceBias(biasPath + "SSP"));
-			device.configSet(DAVIS_CONFIG_BIAS, DAVIS128_CONFIG_BIAS_SSN, generateShiftedSourceBias(biasPath + "SSN"));
+			device->configSet(DAVIS_CONFIG_BIAS, DAVIS128_CONFIG_BIAS_SSP, generateShiftedSourceBias(biasPath + "SSP"));
+			device->configSet(DAVIS_CONFIG_BIAS, DAVIS128_CONFIG_BIAS_SSN, generateShiftedSourceBias(biasPath + "SSN"));
 		}
 
 		if (IS_DAVIS640H(devInfo->chipID)) {
-			device.configSet(DAVIS_CONFIG_BIAS, DAVIS640H_CONFIG_BIAS_APSCAS, generateVDACBias(biasPath + "ApsCas"));
-			device.configSet(DAVIS_CONFIG_BIAS, DAVIS640H_CONFIG_BIAS_OVG1LO, generateVDACBias(biasPath + "OVG1Lo"));
-			device.configSet(DAVIS_CONFIG_BIAS, DAVIS640H_CONFIG_BIAS_OVG2LO, generateVDACBias(biasPath + "OVG2Lo"));
-			device.configSet(
+			device->configSet(DAVIS_CONFIG_BIAS, DAVIS640H_CONFIG_BIAS_APSCAS, generateVDACBias(biasPath + "ApsCas"));
+			device->configSet(DAVIS_CONFIG_BIAS, DAVIS640H_CONFIG_BIAS_OVG1LO, generateVDACBias(biasPath + "OVG1Lo"));
+			device->configSet(DAVIS_CONFIG_BIAS, DAVIS640H_CONFIG_BIAS_OVG2LO, generateVDACBias(biasPath + "OVG2Lo"));
+			device->configSet(
 				DAVIS_CONFIG_BIAS, DAVIS640H_CONFIG_BIAS_TX2OVG2HI, generateVDACBias(biasPath + "TX2OVG2Hi"));
-			device.configSet(DAVIS_CONFIG_BIAS, DAVIS640H_CONFIG_BIAS_GND07, generateVDACBias(biasPath + "Gnd07"));
-			device.configSet(
+			device->configSet(DAVIS_CONFIG_BIAS, DAVIS640H_CONFIG_BIAS_GND07, generateVDACBias(biasPath + "Gnd07"));
+			device->configSet(
 				DAVIS_CONFIG_BIAS, DAVIS640H_CONFIG_BIAS_ADCTESTVOLTAGE, generateVDACBias(biasPath + "AdcTestVoltage"));
-			device.configSet(
+			device->configSet(
 				DAVIS_CONFIG_BIAS, DAVIS640H_CONFIG_BIAS_ADCREFHIGH, generateVDACBias(biasPath + "AdcRefHigh"));
-			device.configSet(
+			device->configSet(
 				DAVIS_CONFIG_BIAS, DAVIS640H_CONFIG_BIAS_ADCREFLOW, generateVDACBias(biasPath + "AdcRefLow"));
 
-			device.configSet(
+			device->configSet(
 				DAVIS_CONFIG_BIAS, DAVIS640H_CONFIG_BIAS_IFREFRBN, generateCoarseFineBias(biasPath + "IFRefrBn"));
-			device.configSet(
+			device->configSet(
 				DAVIS_CONFIG_BIAS, DAVIS640H_CONFIG_BIAS_IFTHRBN, generateCoarseFineBias(biasPath + "IFThrBn"));
-			device.configSet(
+			device->configSet(
 				DAVIS_CONFIG_BIAS, DAVIS640H_CONFIG_BIAS_LOCALBUFBN, generateCoarseFineBias(biasPath + "LocalBufBn"));
-			device.configSet(
+			device->configSet(
 				DAVIS_CONFIG_BIAS, DAVIS640H_CONFIG_BIAS_PADFOLLBN, generateCoarseFineBias(biasPath + "PadFollBn"));
-			device.configSet(
+			device->configSet(
 				DAVIS_CONFIG_BIAS, DAVIS640H_CONFIG_BIAS_PIXINVBN, generateCoarseFineBias(biasPath + "PixInvBn"));
-			device.configSet(
+			device->configSet(
 				DAVIS_CONFIG_BIAS, DAVIS640H_CONFIG_BIAS_DIFFBN, generateCoarseFineBias(biasPath + "DiffBn"));
-			device.configSet(DAVIS_CONFIG_BIAS, DAVIS640H_CONFIG_BIAS_ONBN, generateCoarseFineBias(biasPath + "OnBn"));
-			device.configSet(
+			device->configSet(DAVIS_CONFIG_BIAS, DAVIS640H_CONFIG_BIAS_ONBN, generateCoarseFineBias(biasPath + "OnBn"));
+			device->configSet(
 				DAVIS_CONFIG_BIAS, DAVIS640H_CONFIG_BIAS_OFFBN, generateCoarseFineBias(biasPath + "OffBn"));
-			device.configSet(DAVIS_CONFIG_BIAS, DAVIS640H_CONFIG_BIAS_PRBP, generateCoarseFineBias(biasPath + "PrBp"));
-			device.configSet(
+			device->configSet(DAVIS_CONFIG_BIAS, DAVIS640H_CONFIG_BIAS_PRBP, generateCoarseFineBias(biasPath + "PrBp"));
+			device->configSet(
 				DAVIS_CONFIG_BIAS, DAVIS640H_CONFIG_BIAS_PRSFBP, generateCoarseFineBias(biasPath + "PrSFBp"));
-			device.configSet(
+			device->configSet(
 				DAVIS_CONFIG_BIAS, DAVIS640H_CONFIG_BIAS_REFRBP, generateCoarseFineBias(biasPath + "RefrBp"));
-			device.configSet(DAVIS_CONFIG_BIAS, DAVIS640H_CONFIG_BIAS_ARRAYBIASBUFFERBN,
+			device->configSet(DAVIS_CONFIG_BIAS, DAVIS640H_CONFIG_BIAS_ARRAYBIASBUFFERBN,
 				generateCoarseFineBias(biasPath + "ArrayBiasBufferBn"));
-			device.configSet(DAVIS_CONFIG_BIAS, DAVIS640H_CONFIG_BIAS_ARRAYLOGICBUFFERBN,
+			device->configSet(DAVIS_CONFIG_BIAS, DAVIS640H_CONFIG_BIAS_ARRAYLOGICBUFFERBN,
 				generateCoarseFineBias(biasPath + "ArrayLogicBufferBn"));
-			device.configSet(
+			device->configSet(
 				DAVIS_CONFIG_BIAS, DAVIS640H_CONFIG_BIAS_FALLTIMEBN, generateCoarseFineBias(biasPath + "FalltimeBn"));
-			device.configSet(
+			device->configSet(
 				DAVIS_CONFIG_BIAS, DAVIS640H_CONFIG_BIAS_RISETIMEBP, generateCoarseFineBias(biasPath + "RisetimeBp"));
-			device.configSet(DAVIS_CONFIG_BIAS, DAVIS640H_CONFIG_BIAS_READOUTBUFBP,
+			device->configSet(DAVIS_CONFIG_BIAS, DAVIS640H_CONFIG_BIAS_READOUTBUFBP,
 				generateCoarseFineBias(biasPath + "ReadoutBufBp"));
-			device.configSet(
+			device->configSet(
 				DAVIS_CONFIG_BIAS, DAVIS640H_CONFIG_BIAS_APSROSFBN, generateCoarseFineBias(biasPath + "ApsROSFBn"));
-			device.configSet(
+			device->configSet(
 				DAVIS_CONFIG_BIAS, DAVIS640H_CONFIG_BIAS_ADCCOMPBP, generateCoarseFineBias(biasPath + "AdcCompBp"));
-			device.configSet(
+			device->configSet(
 				DAVIS_CONFIG_BIAS, DAVIS640H_CONFIG_BIAS_DACBUFBP, generateCoarseFineBias(biasPath + "DACBufBp"));
-			device.configSet(DAVIS_CONFIG_BIAS, DAVIS640H_CONFIG_BIAS_LCOLTIMEOUTBN,
+			device->configSet(DAVIS_CONFIG_BIAS, DAVIS640H_CONFIG_BIAS_LCOLTIMEOUTBN,
 				generateCoarseFineBias(biasPath + "LcolTimeoutBn"));
-			device.configSet(
+			device->configSet(
 				DAVIS_CONFIG_BIAS, DAVIS640H_CONFIG_BIAS_AEPDBN, generateCoarseFineBias(biasPath + "AEPdBn"));
-			device.configSet(
+			device->configSet(
 				DAVIS_CONFIG_BIAS, DAVIS640H_CONFIG_BIAS_AEPUXBP, generateCoarseFineBias(biasPath + "AEPuXBp"));
-			device.configSet(
+			device->configSet(
 				DAVIS_CONFIG_BIAS, DAVIS640H_CONFIG_BIAS_AEPUYBP, generateCoarseFineBias(biasPath + "AEPuYBp"));
 
-			device.configSet(
+			device->configSet(
 				DAVIS_CONFIG_BIAS, DAVIS640H_CONFIG_BIAS_BIASBUFFER, generateCoarseFineBias(biasPath + "BiasBuffer"));
 
-			device.configSet(DAVIS_CONFIG_BIAS, DAVIS640H_CONFIG_BIAS_SSP, generateShiftedSourceBias(biasPath + "SSP"));
-			device.configSet(DAVIS_CONFIG_BIAS, DAVIS640H_CONFIG_BIAS_SSN, generateShiftedSourceBias(biasPath + "SSN"));
+			device->configSet(DAVIS_CONFIG_BIAS, DAVIS640H_CONFIG_BIAS_SSP, generateShiftedSourceBias(biasPath + "SSP"));
+			device->configSet(DAVIS_CONFIG_BIAS, DAVIS640H_CONFIG_BIAS_SSN, generateShiftedSourceBias(biasPath + "SSN"));
 		}
 	}
 
@@ -1137,70 +2206,70 @@ private:
 		auto chipPath = chipIDToName(devInfo->chipID, true) + "chip/";
 
 		// All chips have the same parameter address for the same setting!
-		device.configSet(DAVIS_CONFIG_CHIP, DAVIS128_CONFIG_CHIP_DIGITALMUX0,
+		device->configSet(DAVIS_CONFIG_CHIP, DAVIS128_CONFIG_CHIP_DIGITALMUX0,
 			static_cast<uint32_t>(config.getInt(chipPath + "DigitalMux0")));
-		device.configSet(DAVIS_CONFIG_CHIP, DAVIS128_CONFIG_CHIP_DIGITALMUX1,
+		device->configSet(DAVIS_CONFIG_CHIP, DAVIS128_CONFIG_CHIP_DIGITALMUX1,
 			static_cast<uint32_t>(config.getInt(chipPath + "DigitalMux1")));
-		device.configSet(DAVIS_CONFIG_CHIP, DAVIS128_CONFIG_CHIP_DIGITALMUX2,
+		device->configSet(DAVIS_CONFIG_CHIP, DAVIS128_CONFIG_CHIP_DIGITALMUX2,
 			static_cast<uint32_t>(config.getInt(chipPath + "DigitalMux2")));
-		device.configSet(DAVIS_CONFIG_CHIP, DAVIS128_CONFIG_CHIP_DIGITALMUX3,
+		device->configSet(DAVIS_CONFIG_CHIP, DAVIS128_CONFIG_CHIP_DIGITALMUX3,
 			static_cast<uint32_t>(config.getInt(chipPath + "DigitalMux3")));
-		device.configSet(DAVIS_CONFIG_CHIP, DAVIS128_CONFIG_CHIP_ANALOGMUX0,
+		device->configSet(DAVIS_CONFIG_CHIP, DAVIS128_CONFIG_CHIP_ANALOGMUX0,
 			static_cast<uint32_t>(config.getInt(chipPath + "AnalogMux0")));
-		device.configSet(DAVIS_CONFIG_CHIP, DAVIS128_CONFIG_CHIP_ANALOGMUX1,
+		device->configSet(DAVIS_CONFIG_CHIP, DAVIS128_CONFIG_CHIP_ANALOGMUX1,
 			static_cast<uint32_t>(config.getInt(chipPath + "AnalogMux1")));
-		device.configSet(DAVIS_CONFIG_CHIP, DAVIS128_CONFIG_CHIP_ANALOGMUX2,
+		device->configSet(DAVIS_CONFIG_CHIP, DAVIS128_CONFIG_CHIP_ANALOGMUX2,
 			static_cast<uint32_t>(config.getInt(chipPath + "AnalogMux2")));
-		device.configSet(DAVIS_CONFIG_CHIP, DAVIS128_CONFIG_CHIP_BIASMUX0,
+		device->configSet(DAVIS_CONFIG_CHIP, DAVIS128_CONFIG_CHIP_BIASMUX0,
 			static_cast<uint32_t>(config.getInt(chipPath + "BiasMux0")));
 
-		device.configSet(
+		device->configSet(
 			DAVIS_CONFIG_CHIP, DAVIS128_CONFIG_CHIP_RESETCALIBNEURON, config.getBool(chipPath + "ResetCalibNeuron"));
-		device.configSet(
+		device->configSet(
 			DAVIS_CONFIG_CHIP, DAVIS128_CONFIG_CHIP_TYPENCALIBNEURON, config.getBool(chipPath + "TypeNCalibNeuron"));
-		device.configSet(
+		device->configSet(
 			DAVIS_CONFIG_CHIP, DAVIS128_CONFIG_CHIP_RESETTESTPIXEL, config.getBool(chipPath + "ResetTestPixel"));
-		device.configSet(DAVIS_CONFIG_CHIP, DAVIS128_CONFIG_CHIP_AERNAROW, config.getBool(chipPath + "AERnArow"));
-		device.configSet(DAVIS_CONFIG_CHIP, DAVIS128_CONFIG_CHIP_USEAOUT, config.getBool(chipPath + "UseAOut"));
+		device->configSet(DAVIS_CONFIG_CHIP, DAVIS128_CONFIG_CHIP_AERNAROW, config.getBool(chipPath + "AERnArow"));
+		device->configSet(DAVIS_CONFIG_CHIP, DAVIS128_CONFIG_CHIP_USEAOUT, config.getBool(chipPath + "UseAOut"));
 
 		if (IS_DAVIS240A(devInfo->chipID) || IS_DAVIS240B(devInfo->chipID)) {
-			device.configSet(DAVIS_CONFIG_CHIP, DAVIS240_CONFIG_CHIP_SPECIALPIXELCONTROL,
+			device->configSet(DAVIS_CONFIG_CHIP, DAVIS240_CONFIG_CHIP_SPECIALPIXELCONTROL,
 				config.getBool(chipPath + "SpecialPixelControl"));
 		}
 
 		if (IS_DAVIS128(devInfo->chipID) || IS_DAVIS208(devInfo->chipID) || IS_DAVIS346(devInfo->chipID)
 			|| IS_DAVIS640(devInfo->chipID) || IS_DAVIS640H(devInfo->chipID)) {
-			device.configSet(DAVIS_CONFIG_CHIP, DAVIS128_CONFIG_CHIP_SELECTGRAYCOUNTER,
+			device->configSet(DAVIS_CONFIG_CHIP, DAVIS128_CONFIG_CHIP_SELECTGRAYCOUNTER,
 				config.getBool(chipPath + "SelectGrayCounter"));
 		}
 
 		if (IS_DAVIS346(devInfo->chipID) || IS_DAVIS640(devInfo->chipID) || IS_DAVIS640H(devInfo->chipID)) {
-			device.configSet(DAVIS_CONFIG_CHIP, DAVIS346_CONFIG_CHIP_TESTADC, config.getBool(chipPath + "TestADC"));
+			device->configSet(DAVIS_CONFIG_CHIP, DAVIS346_CONFIG_CHIP_TESTADC, config.getBool(chipPath + "TestADC"));
 		}
 
 		if (IS_DAVIS208(devInfo->chipID)) {
-			device.configSet(
+			device->configSet(
 				DAVIS_CONFIG_CHIP, DAVIS208_CONFIG_CHIP_SELECTPREAMPAVG, config.getBool(chipPath + "SelectPreAmpAvg"));
-			device.configSet(
+			device->configSet(
 				DAVIS_CONFIG_CHIP, DAVIS208_CONFIG_CHIP_SELECTBIASREFSS, config.getBool(chipPath + "SelectBiasRefSS"));
-			device.configSet(
+			device->configSet(
 				DAVIS_CONFIG_CHIP, DAVIS208_CONFIG_CHIP_SELECTSENSE, config.getBool(chipPath + "SelectSense"));
-			device.configSet(
+			device->configSet(
 				DAVIS_CONFIG_CHIP, DAVIS208_CONFIG_CHIP_SELECTPOSFB, config.getBool(chipPath + "SelectPosFb"));
-			device.configSet(
+			device->configSet(
 				DAVIS_CONFIG_CHIP, DAVIS208_CONFIG_CHIP_SELECTHIGHPASS, config.getBool(chipPath + "SelectHighPass"));
 		}
 
 		if (IS_DAVIS640H(devInfo->chipID)) {
-			device.configSet(
+			device->configSet(
 				DAVIS_CONFIG_CHIP, DAVIS640H_CONFIG_CHIP_ADJUSTOVG1LO, config.getBool(chipPath + "AdjustOVG1Lo"));
-			device.configSet(
+			device->configSet(
 				DAVIS_CONFIG_CHIP, DAVIS640H_CONFIG_CHIP_ADJUSTOVG2LO, config.getBool(chipPath + "AdjustOVG2Lo"));
-			device.configSet(
+			device->configSet(
 				DAVIS_CONFIG_CHIP, DAVIS640H_CONFIG_CHIP_ADJUSTTX2OVG2HI, config.getBool(chipPath + "AdjustTX2OVG2Hi"));
 		}
 
-		device.configSet(DAVIS_CONFIG_MUX, DAVIS_CONFIG_MUX_RUN_CHIP, config.getBool(chipPath + "BiasEnable"));
+		device->configSet(DAVIS_CONFIG_MUX, DAVIS_CONFIG_MUX_RUN_CHIP, config.getBool(chipPath + "BiasEnable"));
 	}
 
 	static void chipConfigListener(dvConfigNode node, void *userData, enum dvConfigAttributeEvents event,
@@ -1332,23 +2401,21 @@ private:
 			config.add("statistics/muxDroppedExtInput",
 				dv::ConfigOption::statisticOption("Number of dropped External Input events due to USB full."));
 
-			auto statNode = moduleNode.getRelativeNode("statistics/");
-
-			statNode.attributeUpdaterAdd("muxDroppedDVS", dv::CfgType::LONG, &statisticsUpdater, &device);
-			statNode.attributeUpdaterAdd("muxDroppedExtInput", dv::CfgType::LONG, &statisticsUpdater, &device);
+			statisticsEnable("muxDroppedDVS");
+			statisticsEnable("muxDroppedExtInput");
 
 			config.setPriorityOptions({"statistics/"});
 		}
 	}
 
 	void multiplexerConfigSend() {
-		device.configSet(DAVIS_CONFIG_MUX, DAVIS_CONFIG_MUX_TIMESTAMP_RESET, false);
-		device.configSet(DAVIS_CONFIG_MUX, DAVIS_CONFIG_MUX_DROP_DVS_ON_TRANSFER_STALL,
+		device->configSet(DAVIS_CONFIG_MUX, DAVIS_CONFIG_MUX_TIMESTAMP_RESET, false);
+		device->configSet(DAVIS_CONFIG_MUX, DAVIS_CONFIG_MUX_DROP_DVS_ON_TRANSFER_STALL,
 			config.getBool("multiplexer/DropDVSOnTransferStall"));
-		device.configSet(DAVIS_CONFIG_MUX, DAVIS_CONFIG_MUX_DROP_EXTINPUT_ON_TRANSFER_STALL,
+		device->configSet(DAVIS_CONFIG_MUX, DAVIS_CONFIG_MUX_DROP_EXTINPUT_ON_TRANSFER_STALL,
 			config.getBool("multiplexer/DropExtInputOnTransferStall"));
-		device.configSet(DAVIS_CONFIG_MUX, DAVIS_CONFIG_MUX_TIMESTAMP_RUN, config.getBool("multiplexer/TimestampRun"));
-		device.configSet(DAVIS_CONFIG_MUX, DAVIS_CONFIG_MUX_RUN, config.getBool("multiplexer/Run"));
+		device->configSet(DAVIS_CONFIG_MUX, DAVIS_CONFIG_MUX_TIMESTAMP_RUN, config.getBool("multiplexer/TimestampRun"));
+		device->configSet(DAVIS_CONFIG_MUX, DAVIS_CONFIG_MUX_RUN, config.getBool("multiplexer/Run"));
 	}
 
 	static void multiplexerConfigListener(dvConfigNode node, void *userData, enum dvConfigAttributeEvents event,
@@ -1510,11 +2577,9 @@ private:
 			config.add("statistics/dvsEventsDropped",
 				dv::ConfigOption::statisticOption("Number of dropped events (groups of events)."));
 
-			auto statNode = moduleNode.getRelativeNode("statistics/");
-
-			statNode.attributeUpdaterAdd("dvsEventsRow", dv::CfgType::LONG, &statisticsUpdater, &device);
-			statNode.attributeUpdaterAdd("dvsEventsColumn", dv::CfgType::LONG, &statisticsUpdater, &device);
-			statNode.attributeUpdaterAdd("dvsEventsDropped", dv::CfgType::LONG, &statisticsUpdater, &device);
+			statisticsEnable("dvsEventsRow");
+			statisticsEnable("dvsEventsColumn");
+			statisticsEnable("dvsEventsDropped");
 
 			config.setPriorityOptions({"statistics/"});
 
@@ -1522,7 +2587,7 @@ private:
 				config.add("statistics/dvsFilteredPixel",
 					dv::ConfigOption::statisticOption("Number of events filtered out by the Pixel Filter."));
 
-				statNode.attributeUpdaterAdd("dvsFilteredPixel", dv::CfgType::LONG, &statisticsUpdater, &device);
+				statisticsEnable("dvsFilteredPixel");
 			}
 
 			if (devInfo->dvsHasBackgroundActivityFilter) {
@@ -1531,95 +2596,95 @@ private:
 				config.add("statistics/dvsFilteredRate",
 					dv::ConfigOption::statisticOption("Number of events filtered out by the Rate Filter."));
 
-				statNode.attributeUpdaterAdd("dvsFilteredNoise", dv::CfgType::LONG, &statisticsUpdater, &device);
-				statNode.attributeUpdaterAdd("dvsFilteredRate", dv::CfgType::LONG, &statisticsUpdater, &device);
+				statisticsEnable("dvsFilteredNoise");
+				statisticsEnable("dvsFilteredRate");
 			}
 		}
 	}
 
 	void dvsConfigSend(const struct caer_davis_info *devInfo) {
-		device.configSet(DAVIS_CONFIG_DVS, DAVIS_CONFIG_DVS_WAIT_ON_TRANSFER_STALL,
+		device->configSet(DAVIS_CONFIG_DVS, DAVIS_CONFIG_DVS_WAIT_ON_TRANSFER_STALL,
 			static_cast<uint32_t>(config.getBool("dvs/WaitOnTransferStall")));
-		device.configSet(DAVIS_CONFIG_DVS, DAVIS_CONFIG_DVS_EXTERNAL_AER_CONTROL,
+		device->configSet(DAVIS_CONFIG_DVS, DAVIS_CONFIG_DVS_EXTERNAL_AER_CONTROL,
 			static_cast<uint32_t>(config.getBool("dvs/ExternalAERControl")));
 
 		if (devInfo->dvsHasPixelFilter) {
-			device.configSet(DAVIS_CONFIG_DVS, DAVIS_CONFIG_DVS_FILTER_PIXEL_0_ROW,
+			device->configSet(DAVIS_CONFIG_DVS, DAVIS_CONFIG_DVS_FILTER_PIXEL_0_ROW,
 				static_cast<uint32_t>(config.getInt("dvs/PixelFilter/Pixel0Row")));
-			device.configSet(DAVIS_CONFIG_DVS, DAVIS_CONFIG_DVS_FILTER_PIXEL_0_COLUMN,
+			device->configSet(DAVIS_CONFIG_DVS, DAVIS_CONFIG_DVS_FILTER_PIXEL_0_COLUMN,
 				static_cast<uint32_t>(config.getInt("dvs/PixelFilter/Pixel0Column")));
-			device.configSet(DAVIS_CONFIG_DVS, DAVIS_CONFIG_DVS_FILTER_PIXEL_1_ROW,
+			device->configSet(DAVIS_CONFIG_DVS, DAVIS_CONFIG_DVS_FILTER_PIXEL_1_ROW,
 				static_cast<uint32_t>(config.getInt("dvs/PixelFilter/Pixel1Row")));
-			device.configSet(DAVIS_CONFIG_DVS, DAVIS_CONFIG_DVS_FILTER_PIXEL_1_COLUMN,
+			device->configSet(DAVIS_CONFIG_DVS, DAVIS_CONFIG_DVS_FILTER_PIXEL_1_COLUMN,
 				static_cast<uint32_t>(config.getInt("dvs/PixelFilter/Pixel1Column")));
-			device.configSet(DAVIS_CONFIG_DVS, DAVIS_CONFIG_DVS_FILTER_PIXEL_2_ROW,
+			device->configSet(DAVIS_CONFIG_DVS, DAVIS_CONFIG_DVS_FILTER_PIXEL_2_ROW,
 				static_cast<uint32_t>(config.getInt("dvs/PixelFilter/Pixel2Row")));
-			device.configSet(DAVIS_CONFIG_DVS, DAVIS_CONFIG_DVS_FILTER_PIXEL_2_COLUMN,
+			device->configSet(DAVIS_CONFIG_DVS, DAVIS_CONFIG_DVS_FILTER_PIXEL_2_COLUMN,
 				static_cast<uint32_t>(config.getInt("dvs/PixelFilter/Pixel2Column")));
-			device.configSet(DAVIS_CONFIG_DVS, DAVIS_CONFIG_DVS_FILTER_PIXEL_3_ROW,
+			device->configSet(DAVIS_CONFIG_DVS, DAVIS_CONFIG_DVS_FILTER_PIXEL_3_ROW,
 				static_cast<uint32_t>(config.getInt("dvs/PixelFilter/Pixel3Row")));
-			device.configSet(DAVIS_CONFIG_DVS, DAVIS_CONFIG_DVS_FILTER_PIXEL_3_COLUMN,
+			device->configSet(DAVIS_CONFIG_DVS, DAVIS_CONFIG_DVS_FILTER_PIXEL_3_COLUMN,
 				static_cast<uint32_t>(config.getInt("dvs/PixelFilter/Pixel3Column")));
-			device.configSet(DAVIS_CONFIG_DVS, DAVIS_CONFIG_DVS_FILTER_PIXEL_4_ROW,
+			device->configSet(DAVIS_CONFIG_DVS, DAVIS_CONFIG_DVS_FILTER_PIXEL_4_ROW,
 				static_cast<uint32_t>(config.getInt("dvs/PixelFilter/Pixel4Row")));
-			device.configSet(DAVIS_CONFIG_DVS, DAVIS_CONFIG_DVS_FILTER_PIXEL_4_COLUMN,
+			device->configSet(DAVIS_CONFIG_DVS, DAVIS_CONFIG_DVS_FILTER_PIXEL_4_COLUMN,
 				static_cast<uint32_t>(config.getInt("dvs/PixelFilter/Pixel4Column")));
-			device.configSet(DAVIS_CONFIG_DVS, DAVIS_CONFIG_DVS_FILTER_PIXEL_5_ROW,
+			device->configSet(DAVIS_CONFIG_DVS, DAVIS_CONFIG_DVS_FILTER_PIXEL_5_ROW,
 				static_cast<uint32_t>(config.getInt("dvs/PixelFilter/Pixel5Row")));
-			device.configSet(DAVIS_CONFIG_DVS, DAVIS_CONFIG_DVS_FILTER_PIXEL_5_COLUMN,
+			device->configSet(DAVIS_CONFIG_DVS, DAVIS_CONFIG_DVS_FILTER_PIXEL_5_COLUMN,
 				static_cast<uint32_t>(config.getInt("dvs/PixelFilter/Pixel5Column")));
-			device.configSet(DAVIS_CONFIG_DVS, DAVIS_CONFIG_DVS_FILTER_PIXEL_6_ROW,
+			device->configSet(DAVIS_CONFIG_DVS, DAVIS_CONFIG_DVS_FILTER_PIXEL_6_ROW,
 				static_cast<uint32_t>(config.getInt("dvs/PixelFilter/Pixel6Row")));
-			device.configSet(DAVIS_CONFIG_DVS, DAVIS_CONFIG_DVS_FILTER_PIXEL_6_COLUMN,
+			device->configSet(DAVIS_CONFIG_DVS, DAVIS_CONFIG_DVS_FILTER_PIXEL_6_COLUMN,
 				static_cast<uint32_t>(config.getInt("dvs/PixelFilter/Pixel6Column")));
-			device.configSet(DAVIS_CONFIG_DVS, DAVIS_CONFIG_DVS_FILTER_PIXEL_7_ROW,
+			device->configSet(DAVIS_CONFIG_DVS, DAVIS_CONFIG_DVS_FILTER_PIXEL_7_ROW,
 				static_cast<uint32_t>(config.getInt("dvs/PixelFilter/Pixel7Row")));
-			device.configSet(DAVIS_CONFIG_DVS, DAVIS_CONFIG_DVS_FILTER_PIXEL_7_COLUMN,
+			device->configSet(DAVIS_CONFIG_DVS, DAVIS_CONFIG_DVS_FILTER_PIXEL_7_COLUMN,
 				static_cast<uint32_t>(config.getInt("dvs/PixelFilter/Pixel7Column")));
-			device.configSet(DAVIS_CONFIG_DVS, DAVIS_CONFIG_DVS_FILTER_PIXEL_AUTO_TRAIN,
+			device->configSet(DAVIS_CONFIG_DVS, DAVIS_CONFIG_DVS_FILTER_PIXEL_AUTO_TRAIN,
 				config.getBool("dvs/PixelFilter/AutoTrain"));
 		}
 
 		if (devInfo->dvsHasBackgroundActivityFilter) {
-			device.configSet(DAVIS_CONFIG_DVS, DAVIS_CONFIG_DVS_FILTER_BACKGROUND_ACTIVITY,
+			device->configSet(DAVIS_CONFIG_DVS, DAVIS_CONFIG_DVS_FILTER_BACKGROUND_ACTIVITY,
 				config.getBool("dvs/NoiseFilter/Enable"));
-			device.configSet(DAVIS_CONFIG_DVS, DAVIS_CONFIG_DVS_FILTER_BACKGROUND_ACTIVITY_TIME,
+			device->configSet(DAVIS_CONFIG_DVS, DAVIS_CONFIG_DVS_FILTER_BACKGROUND_ACTIVITY_TIME,
 				static_cast<uint32_t>(config.getInt("dvs/NoiseFilter/Time")));
-			device.configSet(
+			device->configSet(
 				DAVIS_CONFIG_DVS, DAVIS_CONFIG_DVS_FILTER_REFRACTORY_PERIOD, config.getBool("dvs/RateFilter/Enable"));
-			device.configSet(DAVIS_CONFIG_DVS, DAVIS_CONFIG_DVS_FILTER_REFRACTORY_PERIOD_TIME,
+			device->configSet(DAVIS_CONFIG_DVS, DAVIS_CONFIG_DVS_FILTER_REFRACTORY_PERIOD_TIME,
 				static_cast<uint32_t>(config.getInt("dvs/RateFilter/Time")));
 		}
 
 		if (devInfo->dvsHasROIFilter) {
-			device.configSet(DAVIS_CONFIG_DVS, DAVIS_CONFIG_DVS_FILTER_ROI_START_COLUMN,
+			device->configSet(DAVIS_CONFIG_DVS, DAVIS_CONFIG_DVS_FILTER_ROI_START_COLUMN,
 				static_cast<uint32_t>(config.getInt("dvs/ROIFilter/StartColumn")));
-			device.configSet(DAVIS_CONFIG_DVS, DAVIS_CONFIG_DVS_FILTER_ROI_START_ROW,
+			device->configSet(DAVIS_CONFIG_DVS, DAVIS_CONFIG_DVS_FILTER_ROI_START_ROW,
 				static_cast<uint32_t>(config.getInt("dvs/ROIFilter/StartRow")));
-			device.configSet(DAVIS_CONFIG_DVS, DAVIS_CONFIG_DVS_FILTER_ROI_END_COLUMN,
+			device->configSet(DAVIS_CONFIG_DVS, DAVIS_CONFIG_DVS_FILTER_ROI_END_COLUMN,
 				static_cast<uint32_t>(config.getInt("dvs/ROIFilter/EndColumn")));
-			device.configSet(DAVIS_CONFIG_DVS, DAVIS_CONFIG_DVS_FILTER_ROI_END_ROW,
+			device->configSet(DAVIS_CONFIG_DVS, DAVIS_CONFIG_DVS_FILTER_ROI_END_ROW,
 				static_cast<uint32_t>(config.getInt("dvs/ROIFilter/EndRow")));
 		}
 
 		if (devInfo->dvsHasSkipFilter) {
-			device.configSet(
+			device->configSet(
 				DAVIS_CONFIG_DVS, DAVIS_CONFIG_DVS_FILTER_SKIP_EVENTS, config.getBool("dvs/SkipFilter/Enable"));
-			device.configSet(DAVIS_CONFIG_DVS, DAVIS_CONFIG_DVS_FILTER_SKIP_EVENTS_EVERY,
+			device->configSet(DAVIS_CONFIG_DVS, DAVIS_CONFIG_DVS_FILTER_SKIP_EVENTS_EVERY,
 				static_cast<uint32_t>(config.getInt("dvs/SkipFilter/SkipEveryEvents")));
 		}
 
 		if (devInfo->dvsHasPolarityFilter) {
-			device.configSet(DAVIS_CONFIG_DVS, DAVIS_CONFIG_DVS_FILTER_POLARITY_FLATTEN,
+			device->configSet(DAVIS_CONFIG_DVS, DAVIS_CONFIG_DVS_FILTER_POLARITY_FLATTEN,
 				config.getBool("dvs/PolarityFilter/Flatten"));
-			device.configSet(DAVIS_CONFIG_DVS, DAVIS_CONFIG_DVS_FILTER_POLARITY_SUPPRESS,
+			device->configSet(DAVIS_CONFIG_DVS, DAVIS_CONFIG_DVS_FILTER_POLARITY_SUPPRESS,
 				config.getBool("dvs/PolarityFilter/Suppress"));
-			device.configSet(DAVIS_CONFIG_DVS, DAVIS_CONFIG_DVS_FILTER_POLARITY_SUPPRESS_TYPE,
+			device->configSet(DAVIS_CONFIG_DVS, DAVIS_CONFIG_DVS_FILTER_POLARITY_SUPPRESS_TYPE,
 				config.getBool("dvs/PolarityFilter/SuppressType"));
 		}
 
 		bool runDVS = (config.getString("dataMode").find("Events") != std::string::npos);
-		device.configSet(DAVIS_CONFIG_DVS, DAVIS_CONFIG_DVS_RUN, runDVS);
+		device->configSet(DAVIS_CONFIG_DVS, DAVIS_CONFIG_DVS_RUN, runDVS);
 	}
 
 	static void dvsConfigListener(dvConfigNode node, void *userData, enum dvConfigAttributeEvents event,
@@ -1773,6 +2838,21 @@ private:
 		config.add("aps/FrameMode",
 			dv::ConfigOption::listOption("Select frame output mode.", "Default", {"Default", "Grayscale", "Original"}));
 
+		config.add("frameStatistics/Enable",
+			dv::ConfigOption::boolOption("Compute a luminance histogram, mean and clipped pixels of each frame during "
+										 "conversion, for external exposure control.",
+				false));
+		config.add("frameStatistics/PublishInterval",
+			dv::ConfigOption::intOption(
+				"Minimum time between updates of the frameStatistics/ attributes (in ms), frames in between are "
+				"not published.",
+				200, 10, 10000));
+
+		config.add("aps/HostDemosaic",
+			dv::ConfigOption::boolOption("Convert raw color frames (FrameMode Original on color sensors) to BGR on "
+										 "the host, during conversion (bilinear).",
+				false));
+
 		config.setPriorityOptions({"aps/FrameMode", "aps/AutoExposure", "aps/Exposure", "aps/FrameInterval"});
 	}
 
@@ -1813,55 +2893,55 @@ private:
 	}
 
 	void apsConfigSend(const struct caer_davis_info *devInfo) {
-		device.configSet(
+		device->configSet(
 			DAVIS_CONFIG_APS, DAVIS_CONFIG_APS_WAIT_ON_TRANSFER_STALL, config.getBool("aps/WaitOnTransferStall"));
 
 		if (devInfo->apsHasGlobalShutter) {
-			device.configSet(DAVIS_CONFIG_APS, DAVIS_CONFIG_APS_GLOBAL_SHUTTER, config.getBool("aps/GlobalShutter"));
+			device->configSet(DAVIS_CONFIG_APS, DAVIS_CONFIG_APS_GLOBAL_SHUTTER, config.getBool("aps/GlobalShutter"));
 		}
 
-		device.configSet(
+		device->configSet(
 			DAVIS_CONFIG_APS, DAVIS_CONFIG_APS_START_COLUMN_0, static_cast<uint32_t>(config.getInt("aps/StartColumn")));
-		device.configSet(
+		device->configSet(
 			DAVIS_CONFIG_APS, DAVIS_CONFIG_APS_START_ROW_0, static_cast<uint32_t>(config.getInt("aps/StartRow")));
-		device.configSet(
+		device->configSet(
 			DAVIS_CONFIG_APS, DAVIS_CONFIG_APS_END_COLUMN_0, static_cast<uint32_t>(config.getInt("aps/EndColumn")));
-		device.configSet(
+		device->configSet(
 			DAVIS_CONFIG_APS, DAVIS_CONFIG_APS_END_ROW_0, static_cast<uint32_t>(config.getInt("aps/EndRow")));
 
 		// Initialize exposure in backend (libcaer), so that value is synchronized with it.
-		device.configSet(
+		device->configSet(
 			DAVIS_CONFIG_APS, DAVIS_CONFIG_APS_EXPOSURE, static_cast<uint32_t>(config.getInt("aps/Exposure")));
 
 		moduleNode.getRelativeNode("aps/").attributeUpdaterAdd(
-			"Exposure", dv::CfgType::INT, &apsExposureUpdater, &device);
+			"Exposure", dv::CfgType::INT, &apsExposureUpdater, device.get());
 
-		device.configSet(DAVIS_CONFIG_APS, DAVIS_CONFIG_APS_FRAME_INTERVAL,
+		device->configSet(DAVIS_CONFIG_APS, DAVIS_CONFIG_APS_FRAME_INTERVAL,
 			static_cast<uint32_t>(config.getInt("aps/FrameInterval")));
 
 		// DAVIS RGB extra timing support.
 		if (IS_DAVIS640H(devInfo->chipID)) {
-			device.configSet(DAVIS_CONFIG_APS, DAVIS640H_CONFIG_APS_TRANSFER,
+			device->configSet(DAVIS_CONFIG_APS, DAVIS640H_CONFIG_APS_TRANSFER,
 				static_cast<uint32_t>(config.getInt("aps/TransferTime")));
-			device.configSet(DAVIS_CONFIG_APS, DAVIS640H_CONFIG_APS_RSFDSETTLE,
+			device->configSet(DAVIS_CONFIG_APS, DAVIS640H_CONFIG_APS_RSFDSETTLE,
 				static_cast<uint32_t>(config.getInt("aps/RSFDSettleTime")));
-			device.configSet(DAVIS_CONFIG_APS, DAVIS640H_CONFIG_APS_GSPDRESET,
+			device->configSet(DAVIS_CONFIG_APS, DAVIS640H_CONFIG_APS_GSPDRESET,
 				static_cast<uint32_t>(config.getInt("aps/GSPDResetTime")));
-			device.configSet(DAVIS_CONFIG_APS, DAVIS640H_CONFIG_APS_GSRESETFALL,
+			device->configSet(DAVIS_CONFIG_APS, DAVIS640H_CONFIG_APS_GSRESETFALL,
 				static_cast<uint32_t>(config.getInt("aps/GSResetFallTime")));
-			device.configSet(DAVIS_CONFIG_APS, DAVIS640H_CONFIG_APS_GSTXFALL,
+			device->configSet(DAVIS_CONFIG_APS, DAVIS640H_CONFIG_APS_GSTXFALL,
 				static_cast<uint32_t>(config.getInt("aps/GSTXFallTime")));
-			device.configSet(DAVIS_CONFIG_APS, DAVIS640H_CONFIG_APS_GSFDRESET,
+			device->configSet(DAVIS_CONFIG_APS, DAVIS640H_CONFIG_APS_GSFDRESET,
 				static_cast<uint32_t>(config.getInt("aps/GSFDResetTime")));
 		}
 
-		device.configSet(DAVIS_CONFIG_APS, DAVIS_CONFIG_APS_AUTOEXPOSURE, config.getBool("aps/AutoExposure"));
+		device->configSet(DAVIS_CONFIG_APS, DAVIS_CONFIG_APS_AUTOEXPOSURE, config.getBool("aps/AutoExposure"));
 
-		device.configSet(
+		device->configSet(
 			DAVIS_CONFIG_APS, DAVIS_CONFIG_APS_FRAME_MODE, mapFrameMode(config.getString("aps/FrameMode")));
 
 		bool runAPS = (config.getString("dataMode").find("Frames") != std::string::npos);
-		device.configSet(DAVIS_CONFIG_APS, DAVIS_CONFIG_APS_RUN, runAPS);
+		device->configSet(DAVIS_CONFIG_APS, DAVIS_CONFIG_APS_RUN, runAPS);
 	}
 
 	static void apsConfigListener(dvConfigNode node, void *userData, enum dvConfigAttributeEvents event,
@@ -1974,28 +3054,28 @@ private:
 	}
 
 	void imuConfigSend(const struct caer_davis_info *devInfo) {
-		device.configSet(DAVIS_CONFIG_IMU, DAVIS_CONFIG_IMU_SAMPLE_RATE_DIVIDER,
+		device->configSet(DAVIS_CONFIG_IMU, DAVIS_CONFIG_IMU_SAMPLE_RATE_DIVIDER,
 			static_cast<uint32_t>(config.getInt("imu/SampleRateDivider")));
 
 		if (devInfo->imuType == IMU_INVENSENSE_9250) {
-			device.configSet(
+			device->configSet(
 				DAVIS_CONFIG_IMU, DAVIS_CONFIG_IMU_ACCEL_DLPF, static_cast<uint32_t>(config.getInt("imu/AccelDLPF")));
-			device.configSet(
+			device->configSet(
 				DAVIS_CONFIG_IMU, DAVIS_CONFIG_IMU_GYRO_DLPF, static_cast<uint32_t>(config.getInt("imu/GyroDLPF")));
 		}
 		else {
-			device.configSet(DAVIS_CONFIG_IMU, DAVIS_CONFIG_IMU_DIGITAL_LOW_PASS_FILTER,
+			device->configSet(DAVIS_CONFIG_IMU, DAVIS_CONFIG_IMU_DIGITAL_LOW_PASS_FILTER,
 				static_cast<uint32_t>(config.getInt("imu/DigitalLowPassFilter")));
 		}
 
-		device.configSet(DAVIS_CONFIG_IMU, DAVIS_CONFIG_IMU_ACCEL_FULL_SCALE,
+		device->configSet(DAVIS_CONFIG_IMU, DAVIS_CONFIG_IMU_ACCEL_FULL_SCALE,
 			static_cast<uint32_t>(config.getInt("imu/AccelFullScale")));
-		device.configSet(DAVIS_CONFIG_IMU, DAVIS_CONFIG_IMU_GYRO_FULL_SCALE,
+		device->configSet(DAVIS_CONFIG_IMU, DAVIS_CONFIG_IMU_GYRO_FULL_SCALE,
 			static_cast<uint32_t>(config.getInt("imu/GyroFullScale")));
 
-		device.configSet(DAVIS_CONFIG_IMU, DAVIS_CONFIG_IMU_RUN_ACCELEROMETER, config.getBool("imu/RunAccelerometer"));
-		device.configSet(DAVIS_CONFIG_IMU, DAVIS_CONFIG_IMU_RUN_GYROSCOPE, config.getBool("imu/RunGyroscope"));
-		device.configSet(DAVIS_CONFIG_IMU, DAVIS_CONFIG_IMU_RUN_TEMPERATURE, config.getBool("imu/RunTemperature"));
+		device->configSet(DAVIS_CONFIG_IMU, DAVIS_CONFIG_IMU_RUN_ACCELEROMETER, config.getBool("imu/RunAccelerometer"));
+		device->configSet(DAVIS_CONFIG_IMU, DAVIS_CONFIG_IMU_RUN_GYROSCOPE, config.getBool("imu/RunGyroscope"));
+		device->configSet(DAVIS_CONFIG_IMU, DAVIS_CONFIG_IMU_RUN_TEMPERATURE, config.getBool("imu/RunTemperature"));
 	}
 
 	static void imuConfigListener(dvConfigNode node, void *userData, enum dvConfigAttributeEvents event,
@@ -2080,31 +3160,31 @@ private:
 	}
 
 	void externalInputConfigSend(const struct caer_davis_info *devInfo) {
-		device.configSet(DAVIS_CONFIG_EXTINPUT, DAVIS_CONFIG_EXTINPUT_DETECT_RISING_EDGES,
+		device->configSet(DAVIS_CONFIG_EXTINPUT, DAVIS_CONFIG_EXTINPUT_DETECT_RISING_EDGES,
 			config.getBool("externalInput/DetectRisingEdges"));
-		device.configSet(DAVIS_CONFIG_EXTINPUT, DAVIS_CONFIG_EXTINPUT_DETECT_FALLING_EDGES,
+		device->configSet(DAVIS_CONFIG_EXTINPUT, DAVIS_CONFIG_EXTINPUT_DETECT_FALLING_EDGES,
 			config.getBool("externalInput/DetectFallingEdges"));
-		device.configSet(
+		device->configSet(
 			DAVIS_CONFIG_EXTINPUT, DAVIS_CONFIG_EXTINPUT_DETECT_PULSES, config.getBool("externalInput/DetectPulses"));
-		device.configSet(DAVIS_CONFIG_EXTINPUT, DAVIS_CONFIG_EXTINPUT_DETECT_PULSE_POLARITY,
+		device->configSet(DAVIS_CONFIG_EXTINPUT, DAVIS_CONFIG_EXTINPUT_DETECT_PULSE_POLARITY,
 			config.getBool("externalInput/DetectPulsePolarity"));
-		device.configSet(DAVIS_CONFIG_EXTINPUT, DAVIS_CONFIG_EXTINPUT_DETECT_PULSE_LENGTH,
+		device->configSet(DAVIS_CONFIG_EXTINPUT, DAVIS_CONFIG_EXTINPUT_DETECT_PULSE_LENGTH,
 			static_cast<uint32_t>(config.getInt("externalInput/DetectPulseLength")));
-		device.configSet(
+		device->configSet(
 			DAVIS_CONFIG_EXTINPUT, DAVIS_CONFIG_EXTINPUT_RUN_DETECTOR, config.getBool("externalInput/RunDetector"));
 
 		if (devInfo->extInputHasGenerator) {
-			device.configSet(DAVIS_CONFIG_EXTINPUT, DAVIS_CONFIG_EXTINPUT_GENERATE_PULSE_POLARITY,
+			device->configSet(DAVIS_CONFIG_EXTINPUT, DAVIS_CONFIG_EXTINPUT_GENERATE_PULSE_POLARITY,
 				config.getBool("externalInput/GeneratePulsePolarity"));
-			device.configSet(DAVIS_CONFIG_EXTINPUT, DAVIS_CONFIG_EXTINPUT_GENERATE_PULSE_INTERVAL,
+			device->configSet(DAVIS_CONFIG_EXTINPUT, DAVIS_CONFIG_EXTINPUT_GENERATE_PULSE_INTERVAL,
 				static_cast<uint32_t>(config.getInt("externalInput/GeneratePulseInterval")));
-			device.configSet(DAVIS_CONFIG_EXTINPUT, DAVIS_CONFIG_EXTINPUT_GENERATE_PULSE_LENGTH,
+			device->configSet(DAVIS_CONFIG_EXTINPUT, DAVIS_CONFIG_EXTINPUT_GENERATE_PULSE_LENGTH,
 				static_cast<uint32_t>(config.getInt("externalInput/GeneratePulseLength")));
-			device.configSet(DAVIS_CONFIG_EXTINPUT, DAVIS_CONFIG_EXTINPUT_GENERATE_INJECT_ON_RISING_EDGE,
+			device->configSet(DAVIS_CONFIG_EXTINPUT, DAVIS_CONFIG_EXTINPUT_GENERATE_INJECT_ON_RISING_EDGE,
 				config.getBool("externalInput/GenerateInjectOnRisingEdge"));
-			device.configSet(DAVIS_CONFIG_EXTINPUT, DAVIS_CONFIG_EXTINPUT_GENERATE_INJECT_ON_FALLING_EDGE,
+			device->configSet(DAVIS_CONFIG_EXTINPUT, DAVIS_CONFIG_EXTINPUT_GENERATE_INJECT_ON_FALLING_EDGE,
 				config.getBool("externalInput/GenerateInjectOnFallingEdge"));
-			device.configSet(DAVIS_CONFIG_EXTINPUT, DAVIS_CONFIG_EXTINPUT_RUN_GENERATOR,
+			device->configSet(DAVIS_CONFIG_EXTINPUT, DAVIS_CONFIG_EXTINPUT_RUN_GENERATOR,
 				config.getBool("externalInput/RunGenerator"));
 		}
 	}
@@ -2183,14 +3263,14 @@ private:
 	}
 
 	void usbConfigSend() {
-		device.configSet(CAER_HOST_CONFIG_USB, CAER_HOST_CONFIG_USB_BUFFER_NUMBER,
+		device->configSet(CAER_HOST_CONFIG_USB, CAER_HOST_CONFIG_USB_BUFFER_NUMBER,
 			static_cast<uint32_t>(config.getInt("usb/BufferNumber")));
-		device.configSet(CAER_HOST_CONFIG_USB, CAER_HOST_CONFIG_USB_BUFFER_SIZE,
+		device->configSet(CAER_HOST_CONFIG_USB, CAER_HOST_CONFIG_USB_BUFFER_SIZE,
 			static_cast<uint32_t>(config.getInt("usb/BufferSize")));
 
-		device.configSet(DAVIS_CONFIG_USB, DAVIS_CONFIG_USB_EARLY_PACKET_DELAY,
+		device->configSet(DAVIS_CONFIG_USB, DAVIS_CONFIG_USB_EARLY_PACKET_DELAY,
 			static_cast<uint32_t>(config.getInt("usb/EarlyPacketDelay")));
-		device.configSet(DAVIS_CONFIG_USB, DAVIS_CONFIG_USB_RUN, config.getBool("usb/Run"));
+		device->configSet(DAVIS_CONFIG_USB, DAVIS_CONFIG_USB_RUN, config.getBool("usb/Run"));
 	}
 
 	static void usbConfigListener(dvConfigNode node, void *userData, enum dvConfigAttributeEvents event,
@@ -2230,24 +3310,233 @@ private:
 			dv::ConfigOption::intOption("Time interval in µs, each sent EventPacketContainer will span this interval.",
 				10000, 1, 120 * 1000 * 1000));
 
-		// Ring-buffer setting (only changes value on module init/shutdown cycles).
+		config.add("system/StatisticsPollInterval",
+			dv::ConfigOption::intOption(
+				"Interval at which the device statistics are read in the background (in ms, 0 = no polling).", 1000,
+				0, 60000));
+
+		// Adaptive packet-container sizing, overwrites the two settings above when enabled.
+		config.add("system/AdaptiveContainers/Enable",
+			dv::ConfigOption::boolOption("Retune PacketContainerInterval and PacketContainerMaxPacketSize at runtime "
+										 "from measured event rate and processing time.",
+				false));
+		config.add("system/AdaptiveContainers/TargetLatency",
+			dv::ConfigOption::intOption(
+				"Upper bound for container interval plus processing time (in µs).", 10000, 100, 1000000));
+		config.add("system/AdaptiveContainers/MinInterval",
+			dv::ConfigOption::intOption(
+				"Lower bound for the container interval, limits per-container overhead (in µs).", 1000, 1, 1000000));
+
+		// Thread placement, for both the libcaer acquisition thread and the mainloop thread converting data.
+		config.add("system/Affinity/AcquisitionCores",
+			dv::ConfigOption::stringOption(
+				"Cores to pin the libcaer acquisition thread to, e.g. \"2\" or \"2-3\" (empty = not pinned).", ""));
+		config.add("system/Affinity/AcquisitionPriority",
+			dv::ConfigOption::intOption(
+				"SCHED_FIFO priority of the acquisition thread (0 = normal scheduling, needs CAP_SYS_NICE).", 0, 0,
+				99));
+		config.add("system/Affinity/ConversionCores",
+			dv::ConfigOption::stringOption(
+				"Cores to pin the module (conversion) thread to, e.g. \"4\" (empty = not pinned).", ""));
+		config.add("system/Affinity/ConversionPriority",
+			dv::ConfigOption::intOption(
+				"SCHED_FIFO priority of the module thread (0 = normal scheduling, needs CAP_SYS_NICE).", 0, 0, 99));
+
+		config.add("system/FrameConversionThreads",
+			dv::ConfigOption::intOption("Extra threads converting the rows of large frames (DAVIS640, color) "
+										"together with the module thread, for lower frame latency (0 = off).",
+				0, 0, 16));
+
+		// Queue between data acquisition thread and mainloop, both can be changed at runtime.
 		config.add("system/DataExchangeBufferSize",
 			dv::ConfigOption::intOption(
 				"Size of EventPacketContainer queue, used for transfers between data acquisition thread and mainloop.",
 				64, 8, 1024));
+		config.add("system/DataExchangePolicy",
+			dv::ConfigOption::listOption("What to do when the queue is full: leave data in libcaer's small buffer "
+										 "(which then drops the newest), drop the oldest or newest container, or "
+										 "drop frames first.",
+				2, {"Block", "DropOldest", "DropNewest", "DropFramesFirst"}));
+
+		config.add("statistics/exchangeDroppedContainers",
+			dv::ConfigOption::statisticOption("Number of containers dropped because the queue was full."));
+		config.add("statistics/exchangeDroppedEvents",
+			dv::ConfigOption::statisticOption("Number of polarity events dropped because the queue was full."));
+		config.add("statistics/exchangeDroppedFrames",
+			dv::ConfigOption::statisticOption("Number of frames dropped because the queue was full."));
+		config.add("statistics/exchangeDroppedIMU",
+			dv::ConfigOption::statisticOption("Number of IMU samples dropped because the queue was full."));
+		config.add("statistics/exchangeDroppedSpecial",
+			dv::ConfigOption::statisticOption(
+				"Number of special events (triggers) dropped because the queue was full."));
+		config.add("statistics/exchangeLastDropTime",
+			dv::ConfigOption::statisticOption("Unix time of the last drop (in µs, 0 = never)."));
+		config.add("statistics/exchangeHighWater",
+			dv::ConfigOption::statisticOption("Most containers queued at once, over the last second."));
 
 		config.setPriorityOptions({"system/"});
 	}
 
+	static void replayConfigCreate(dv::RuntimeConfig &config) {
+		// Only read on module init.
+		config.add("replay/File",
+			dv::ConfigOption::fileOpenOption(
+				"Raw libcaer capture to replay instead of opening a camera (empty = use camera).", "raw"));
+		config.add("replay/Pace",
+			dv::ConfigOption::listOption(
+				"Serve containers at their recorded arrival times, or as fast as possible.", 0, {"Recorded", "Fast"}));
+		config.add(
+			"replay/Loop", dv::ConfigOption::boolOption("Restart from the beginning at the end of the capture.", false));
+		config.add("replay/InjectTimestampReset",
+			dv::ConfigOption::boolOption(
+				"Inject a TIMESTAMP_RESET special event before the capture (and on every loop), to trigger sync.", true));
+
+		config.setPriorityOptions({"replay/File"});
+	}
+
+	static void simdConfigCreate(dv::RuntimeConfig &config) {
+		config.add("simd/ForceVariant",
+			dv::ConfigOption::listOption("Force a SIMD code variant for conversion (A/B testing), Auto selects the "
+										 "best one the CPU supports.",
+				0, {"Auto", "Scalar", "SSE4.2", "AVX2", "AVX-512"}));
+	}
+
+	static void softwareROIConfigCreate(dv::RuntimeConfig &config) {
+		config.add("softwareROI/PositionX",
+			dv::ConfigOption::intOption("Column/X address of the events output start point (applied on module start).",
+				0, 0, INT16_MAX));
+		config.add("softwareROI/PositionY",
+			dv::ConfigOption::intOption(
+				"Row/Y address of the events output start point (applied on module start).", 0, 0, INT16_MAX));
+		config.add("softwareROI/SizeX",
+			dv::ConfigOption::intOption(
+				"Width of the events output region, 0 = up to the sensor edge (applied on module start).", 0, 0,
+				INT16_MAX));
+		config.add("softwareROI/SizeY",
+			dv::ConfigOption::intOption(
+				"Height of the events output region, 0 = up to the sensor edge (applied on module start).", 0, 0,
+				INT16_MAX));
+		config.add("softwareROI/Downsample",
+			dv::ConfigOption::listOption(
+				"Merge blocks of pixels of the events output region into one (applied on module start).", 0,
+				{"Off", "2x2", "4x4"}));
+
+		config.setPriorityOptions({"softwareROI/"});
+	}
+
+	static void triggerFilterConfigCreate(dv::RuntimeConfig &config) {
+		for (const auto &entry : TRIGGER_FILTER_TYPES) {
+			config.add("triggerFilter/" + std::string(entry.first),
+				dv::ConfigOption::boolOption("Send this trigger type to the 'triggers' output.", true));
+		}
+	}
+
+	static void rateGovernorConfigCreate(dv::RuntimeConfig &config) {
+		config.add("rateGovernor/Enable",
+			dv::ConfigOption::boolOption("Adjust the FPGA noise, refractory and skip filters at runtime to hold the "
+										 "event rate at TargetRate. The dvs/ filter settings are the starting point, "
+										 "and are restored when disabled.",
+				false));
+		config.add("rateGovernor/TargetRate",
+			dv::ConfigOption::intOption("Event rate to hold (in kev/s, 1000 = 1 Mev/s).", 5000, 1, 100000));
+
+		config.setPriorityOptions({"rateGovernor/"});
+	}
+
+	static void clockConfigCreate(dv::RuntimeConfig &config) {
+		config.add("clock/Horizon",
+			dv::ConfigOption::intOption(
+				"Time over which the device to host clock estimate averages (in s), longer is smoother but slower "
+				"to follow drift changes.",
+				300, 10, 86400));
+	}
+
+	static void preSyncConfigCreate(dv::RuntimeConfig &config) {
+		config.add("preSync/Enable",
+			dv::ConfigOption::boolOption(
+				"Buffer data received before the sync, and send out its most recent part once the sync arrives.",
+				false));
+		config.add("preSync/Duration",
+			dv::ConfigOption::intOption(
+				"Time before the sync to send out (in ms), re-based to negative timestamps.", 100, 1, 10000));
+
+		// Capacities bound the buffer memory (events 16 bytes, frames up to 4 bytes per pixel).
+		config.add("preSync/MaxEvents",
+			dv::ConfigOption::intOption("Maximum number of polarity events kept.", 1000000, 0, 50000000));
+		config.add("preSync/MaxFrames", dv::ConfigOption::intOption("Maximum number of frames kept.", 4, 0, 100));
+		config.add("preSync/MaxIMUSamples",
+			dv::ConfigOption::intOption("Maximum number of IMU samples kept.", 8192, 0, 1000000));
+
+		config.setPriorityOptions({"preSync/Enable"});
+	}
+
+	static void recorderConfigCreate(dv::RuntimeConfig &config) {
+		config.add("recorder/Enable",
+			dv::ConfigOption::boolOption("Record the raw libcaer data, before any conversion, to disk.", false));
+		config.add("recorder/File",
+			dv::ConfigOption::fileSaveOption(
+				"Base path of the raw capture files, numbered files <base>-<n>.raw are written.", "raw"));
+		config.add("recorder/FileSize",
+			dv::ConfigOption::intOption(
+				"Size of each raw capture file (in MB), preallocated on creation.", 1024, 16, 65536));
+		config.add("recorder/FilesNumber",
+			dv::ConfigOption::intOption(
+				"Number of raw capture files to rotate through, the oldest is overwritten.", 4, 1, 1000));
+		config.add("recorder/QueueSize",
+			dv::ConfigOption::intOption(
+				"Containers that can wait to be written, before new ones are dropped from the recording.", 256, 8,
+				65536));
+
+		config.add("statistics/recorderDroppedContainers",
+			dv::ConfigOption::statisticOption("Number of containers not recorded, because the writer was behind."));
+		config.add("statistics/recorderBytesWritten",
+			dv::ConfigOption::statisticOption("Number of bytes written to raw capture files."));
+
+		config.setPriorityOptions({"recorder/Enable"});
+	}
+
+	static void rawOutputConfigCreate(dv::RuntimeConfig &config) {
+		config.add("rawOutput/Enable",
+			dv::ConfigOption::boolOption("Forward the raw libcaer containers, by reference, to in-process consumers "
+										 "subscribed to RawPassthrough channel rawOutput/Channel.",
+				false));
+		config.add("imuArrays/Enable",
+			dv::ConfigOption::boolOption("Also convert IMU samples to structure of arrays (one array per axis), for "
+										 "in-process consumers subscribed to channel imuArrays/Channel.",
+				false));
+	}
+
+	static void reconnectConfigCreate(dv::RuntimeConfig &config) {
+		config.add("reconnect/Enable",
+			dv::ConfigOption::boolOption(
+				"Reopen the device (same serial number) and restore its configuration if it disconnects, instead of "
+				"stopping the module.",
+				false));
+		config.add("reconnect/RetryInterval",
+			dv::ConfigOption::intOption("Time between reconnection attempts (in ms).", 500, 10, 60000));
+		config.add("reconnect/Timeout",
+			dv::ConfigOption::intOption(
+				"Stop the module if the device is not back after this time (in s, 0 = never).", 0, 0, 86400));
+
+		config.add("statistics/reconnectCount",
+			dv::ConfigOption::statisticOption("Number of successful device reconnections."));
+		config.add("statistics/reconnectLastDowntime",
+			dv::ConfigOption::statisticOption("Duration of the last device disconnection (in ms)."));
+		config.add("statistics/reconnectTotalDowntime",
+			dv::ConfigOption::statisticOption("Total duration of all device disconnections (in ms)."));
+
+		config.setPriorityOptions({"reconnect/Enable"});
+	}
+
 	void systemConfigSend() {
-		device.configSet(CAER_HOST_CONFIG_PACKETS, CAER_HOST_CONFIG_PACKETS_MAX_CONTAINER_PACKET_SIZE,
+		device->configSet(CAER_HOST_CONFIG_PACKETS, CAER_HOST_CONFIG_PACKETS_MAX_CONTAINER_PACKET_SIZE,
 			static_cast<uint32_t>(config.getInt("system/PacketContainerMaxPacketSize")));
-		device.configSet(CAER_HOST_CONFIG_PACKETS, CAER_HOST_CONFIG_PACKETS_MAX_CONTAINER_INTERVAL,
+		device->configSet(CAER_HOST_CONFIG_PACKETS, CAER_HOST_CONFIG_PACKETS_MAX_CONTAINER_INTERVAL,
 			static_cast<uint32_t>(config.getInt("system/PacketContainerInterval")));
 
-		// Changes only take effect on module start!
-		device.configSet(CAER_HOST_CONFIG_DATAEXCHANGE, CAER_HOST_CONFIG_DATAEXCHANGE_BUFFER_SIZE,
-			static_cast<uint32_t>(config.getInt("system/DataExchangeBufferSize")));
+		// Drained on every notification, libcaer's own ring only ever holds a container or two,
+		// except with the Block policy, where it is the overflow.
+		device->configSet(CAER_HOST_CONFIG_DATAEXCHANGE, CAER_HOST_CONFIG_DATAEXCHANGE_BUFFER_SIZE, 8);
 	}
 
 	static void systemConfigListener(dvConfigNode node, void *userData, enum dvConfigAttributeEvents event,
@@ -2302,53 +3591,36 @@ private:
 		}
 	}
 
+	void statisticsEnable(const std::string &key) {
+		statistics.enable(key);
+
+		config.add("statistics/" + key + "Delta",
+			dv::ConfigOption::statisticOption("Change of " + key + " during the last poll interval."));
+		config.add("statistics/" + key + "Rate",
+			dv::ConfigOption::statisticOption("Change of " + key + " per second."));
+
+		auto statNode = moduleNode.getRelativeNode("statistics/");
+
+		// The counter and value kind travel as userData, nothing to parse on each read.
+		using Kind = DavisStatisticsPoller::Kind;
+
+		statNode.attributeUpdaterAdd(key, dv::CfgType::LONG, &statisticsUpdater,
+			const_cast<DavisStatisticsPoller::Reader *>(statistics.reader(key, Kind::VALUE)));
+		statNode.attributeUpdaterAdd(key + "Delta", dv::CfgType::LONG, &statisticsUpdater,
+			const_cast<DavisStatisticsPoller::Reader *>(statistics.reader(key, Kind::DELTA)));
+		statNode.attributeUpdaterAdd(key + "Rate", dv::CfgType::LONG, &statisticsUpdater,
+			const_cast<DavisStatisticsPoller::Reader *>(statistics.reader(key, Kind::RATE)));
+	}
+
 	static union dvConfigAttributeValue statisticsUpdater(
 		void *userData, const char *key, enum dvConfigAttributeType type) {
+		UNUSED_ARGUMENT(key);
 		UNUSED_ARGUMENT(type); // We know all statistics are always LONG.
 
-		auto device = static_cast<libcaer::devices::davis *>(userData);
-
-		std::string keyStr{key};
+		auto reader = static_cast<const DavisStatisticsPoller::Reader *>(userData);
 
-		union dvConfigAttributeValue statisticValue = {.ilong = 0};
-
-		try {
-			if (keyStr == "muxDroppedDVS") {
-				device->configGet64(DAVIS_CONFIG_MUX, DAVIS_CONFIG_MUX_STATISTICS_DVS_DROPPED,
-					reinterpret_cast<uint64_t *>(&statisticValue.ilong));
-			}
-			else if (keyStr == "muxDroppedExtInput") {
-				device->configGet64(DAVIS_CONFIG_MUX, DAVIS_CONFIG_MUX_STATISTICS_EXTINPUT_DROPPED,
-					reinterpret_cast<uint64_t *>(&statisticValue.ilong));
-			}
-			else if (keyStr == "dvsEventsRow") {
-				device->configGet64(DAVIS_CONFIG_DVS, DAVIS_CONFIG_DVS_STATISTICS_EVENTS_ROW,
-					reinterpret_cast<uint64_t *>(&statisticValue.ilong));
-			}
-			else if (keyStr == "dvsEventsColumn") {
-				device->configGet64(DAVIS_CONFIG_DVS, DAVIS_CONFIG_DVS_STATISTICS_EVENTS_COLUMN,
-					reinterpret_cast<uint64_t *>(&statisticValue.ilong));
-			}
-			else if (keyStr == "dvsEventsDropped") {
-				device->configGet64(DAVIS_CONFIG_DVS, DAVIS_CONFIG_DVS_STATISTICS_EVENTS_DROPPED,
-					reinterpret_cast<uint64_t *>(&statisticValue.ilong));
-			}
-			else if (keyStr == "dvsFilteredPixel") {
-				device->configGet64(DAVIS_CONFIG_DVS, DAVIS_CONFIG_DVS_STATISTICS_FILTERED_PIXELS,
-					reinterpret_cast<uint64_t *>(&statisticValue.ilong));
-			}
-			else if (keyStr == "dvsFilteredRate") {
-				device->configGet64(DAVIS_CONFIG_DVS, DAVIS_CONFIG_DVS_STATISTICS_FILTERED_REFRACTORY_PERIOD,
-					reinterpret_cast<uint64_t *>(&statisticValue.ilong));
-			}
-			else if (keyStr == "dvsFilteredNoise") {
-				device->configGet64(DAVIS_CONFIG_DVS, DAVIS_CONFIG_DVS_STATISTICS_FILTERED_BACKGROUND_ACTIVITY,
-					reinterpret_cast<uint64_t *>(&statisticValue.ilong));
-			}
-		}
-		catch (const std::runtime_error &) {
-			// Catch communication failures and ignore them.
-		}
+		// Only the cached value, the USB transfers happen in the poller thread.
+		union dvConfigAttributeValue statisticValue = {.ilong = reader->get()};
 
 		return (statisticValue);
 	}
@@ -0,0 +1,246 @@
+#ifndef DAVIS_STATISTICS_HPP
+#define DAVIS_STATISTICS_HPP
+
+#include "dv-sdk/module.hpp"
+
+#include <libcaercpp/devices/davis.hpp>
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstring>
+#include <mutex>
+#include <string>
+#include <thread>
+
+/**
+ * Background poller for the DAVIS FPGA statistics counters.
+ *
+ * All enabled counters are read back-to-back from a dedicated thread at a
+ * configurable interval (system/StatisticsPollInterval, in ms). Readers of the
+ * statistics/ node only ever load the cached atomics, so they never cause USB
+ * control transfers themselves. For each counter the difference to the previous
+ * poll and the resulting per-second rate are also kept.
+ */
+class DavisStatisticsPoller {
+public:
+	enum class Kind { VALUE, DELTA, RATE };
+
+	struct Statistic {
+		const char *name;
+		uint8_t moduleAddress;
+		uint8_t parameterAddress;
+	};
+
+	static constexpr size_t STATISTICS_NUMBER = 8;
+
+	static constexpr std::array<Statistic, STATISTICS_NUMBER> statistics{{
+		{"muxDroppedDVS", DAVIS_CONFIG_MUX, DAVIS_CONFIG_MUX_STATISTICS_DVS_DROPPED},
+		{"muxDroppedExtInput", DAVIS_CONFIG_MUX, DAVIS_CONFIG_MUX_STATISTICS_EXTINPUT_DROPPED},
+		{"dvsEventsRow", DAVIS_CONFIG_DVS, DAVIS_CONFIG_DVS_STATISTICS_EVENTS_ROW},
+		{"dvsEventsColumn", DAVIS_CONFIG_DVS, DAVIS_CONFIG_DVS_STATISTICS_EVENTS_COLUMN},
+		{"dvsEventsDropped", DAVIS_CONFIG_DVS, DAVIS_CONFIG_DVS_STATISTICS_EVENTS_DROPPED},
+		{"dvsFilteredPixel", DAVIS_CONFIG_DVS, DAVIS_CONFIG_DVS_STATISTICS_FILTERED_PIXELS},
+		{"dvsFilteredRate", DAVIS_CONFIG_DVS, DAVIS_CONFIG_DVS_STATISTICS_FILTERED_REFRACTORY_PERIOD},
+		{"dvsFilteredNoise", DAVIS_CONFIG_DVS, DAVIS_CONFIG_DVS_STATISTICS_FILTERED_BACKGROUND_ACTIVITY},
+	}};
+
+	/**
+	 * One readable value of one counter, stable for the poller's lifetime, to
+	 * register as the config updater's userData.
+	 */
+	struct Reader {
+		const DavisStatisticsPoller *poller;
+		size_t index;
+		Kind kind;
+
+		int64_t get() const {
+			return (poller->get(index, kind));
+		}
+	};
+
+	DavisStatisticsPoller() {
+		for (size_t i = 0; i < STATISTICS_NUMBER; i++) {
+			readers[i] = {{{this, i, Kind::VALUE}, {this, i, Kind::DELTA}, {this, i, Kind::RATE}}};
+		}
+	}
+
+	~DavisStatisticsPoller() {
+		stop();
+	}
+
+	DavisStatisticsPoller(const DavisStatisticsPoller &) = delete;
+	DavisStatisticsPoller &operator=(const DavisStatisticsPoller &) = delete;
+
+	/**
+	 * Enable polling of a statistic. Returns false if the name is unknown.
+	 */
+	bool enable(const std::string &name) {
+		auto idx = indexOf(name.c_str(), name.length());
+
+		if (idx >= STATISTICS_NUMBER) {
+			return (false);
+		}
+
+		cache[idx].enabled.store(true, std::memory_order_relaxed);
+		return (true);
+	}
+
+	void start(libcaer::devices::davis *pollDevice, dv::Cfg::Node pollSystemNode) {
+		stop();
+
+		device     = pollDevice;
+		systemNode = pollSystemNode;
+
+		for (auto &c : cache) {
+			c.initialized = false;
+		}
+
+		stopRequested = false;
+		thread        = std::thread(&DavisStatisticsPoller::threadRun, this);
+	}
+
+	void stop() {
+		if (!thread.joinable()) {
+			return;
+		}
+
+		{
+			std::scoped_lock lock(mutex);
+			stopRequested = true;
+		}
+
+		condition.notify_all();
+		thread.join();
+	}
+
+	/**
+	 * Reader for a counter by name, nullptr if the name is unknown.
+	 */
+	const Reader *reader(const std::string &name, Kind kind) const {
+		auto idx = indexOf(name.c_str(), name.length());
+
+		if (idx >= STATISTICS_NUMBER) {
+			return (nullptr);
+		}
+
+		return (&readers[idx][static_cast<size_t>(kind)]);
+	}
+
+	/**
+	 * Lock-free lookup of the cached value of a counter.
+	 */
+	int64_t get(size_t idx, Kind kind) const {
+		switch (kind) {
+			case Kind::DELTA:
+				return (cache[idx].delta.load(std::memory_order_relaxed));
+
+			case Kind::RATE:
+				return (cache[idx].rate.load(std::memory_order_relaxed));
+
+			case Kind::VALUE:
+			default:
+				return (cache[idx].value.load(std::memory_order_relaxed));
+		}
+	}
+
+private:
+	struct Cache {
+		std::atomic_bool enabled{false};
+		std::atomic<int64_t> value{0};
+		std::atomic<int64_t> delta{0};
+		std::atomic<int64_t> rate{0};
+
+		// Only touched by the poller thread.
+		bool initialized{false};
+		uint64_t previous{0};
+		std::chrono::steady_clock::time_point previousTime;
+	};
+
+	libcaer::devices::davis *device{nullptr};
+	dv::Cfg::Node systemNode{nullptr};
+	std::array<Cache, STATISTICS_NUMBER> cache;
+	std::array<std::array<Reader, 3>, STATISTICS_NUMBER> readers;
+
+	std::thread thread;
+	std::mutex mutex;
+	std::condition_variable condition;
+	bool stopRequested{false};
+
+	static size_t indexOf(const char *name, size_t length) {
+		for (size_t i = 0; i < STATISTICS_NUMBER; i++) {
+			if ((strlen(statistics[i].name) == length) && (strncmp(statistics[i].name, name, length) == 0)) {
+				return (i);
+			}
+		}
+
+		return (STATISTICS_NUMBER);
+	}
+
+	void poll() {
+		for (size_t i = 0; i < STATISTICS_NUMBER; i++) {
+			auto &c = cache[i];
+
+			if (!c.enabled.load(std::memory_order_relaxed)) {
+				continue;
+			}
+
+			uint64_t value = 0;
+
+			try {
+				device->configGet64(statistics[i].moduleAddress, statistics[i].parameterAddress, &value);
+			}
+			catch (const std::runtime_error &) {
+				// Catch communication failures and ignore them.
+				continue;
+			}
+
+			auto now = std::chrono::steady_clock::now();
+
+			if (c.initialized) {
+				// Counters restart from zero on device reset.
+				auto delta = (value >= c.previous) ? (value - c.previous) : (value);
+				auto elapsed
+					= std::chrono::duration_cast<std::chrono::microseconds>(now - c.previousTime).count();
+
+				c.delta.store(static_cast<int64_t>(delta), std::memory_order_relaxed);
+
+				if (elapsed > 0) {
+					c.rate.store(static_cast<int64_t>((static_cast<double>(delta) * 1000000.0) / elapsed),
+						std::memory_order_relaxed);
+				}
+			}
+
+			c.value.store(static_cast<int64_t>(value), std::memory_order_relaxed);
+
+			c.initialized  = true;
+			c.previous     = value;
+			c.previousTime = now;
+		}
+	}
+
+	void threadRun() {
+		std::unique_lock lock(mutex);
+
+		while (!stopRequested) {
+			auto interval = systemNode.getInt("StatisticsPollInterval");
+
+			if (interval > 0) {
+				lock.unlock();
+				poll();
+				lock.lock();
+			}
+			else {
+				// Polling disabled, just check back later.
+				interval = 100;
+			}
+
+			condition.wait_for(lock, std::chrono::milliseconds(interval), [this] {
+				return (stopRequested);
+			});
+		}
+	}
+};
+
+#endif // DAVIS_STATISTICS_HPP
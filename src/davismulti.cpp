@@ -0,0 +1,555 @@
+#define DV_API_OPENCV_SUPPORT 0
+
+#include "dv-sdk/cross/portable_time.h"
+#include "dv-sdk/data/event.hpp"
+#include "dv-sdk/data/frame.hpp"
+#include "dv-sdk/data/imu.hpp"
+#include "dv-sdk/data/trigger.hpp"
+#include "dv-sdk/module.hpp"
+
+#include "log.hpp"
+#include "aedat4_convert.hpp"
+#include "aedat4_converter.hpp"
+#include "event_merger.hpp"
+#include "timestamp_reset.hpp"
+
+#include <libcaercpp/devices/davis.hpp>
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+/**
+ * Several hardware-synchronized DAVIS cameras in one module. Each camera gets
+ * its own set of outputs (events0, frames0, triggers0, imu0, ...). Data is only
+ * sent out once every camera has seen the sync TIMESTAMP_RESET; cameras that
+ * see it earlier hold their data until then. Optionally all polarity events
+ * are also merged, in timestamp order, into one output with the cameras tiled
+ * side by side.
+ *
+ * Device configuration is limited to the essentials shared by all cameras, use
+ * nvp_syncdavis for the full per-device settings.
+ */
+class davismulti : public dv::ModuleBase {
+private:
+	static constexpr size_t MAX_CAMERAS = 4;
+
+	// Containers a synchronized camera holds while waiting for the others.
+	static constexpr size_t MAX_PENDING_CONTAINERS = 1024;
+
+	struct PendingContainer {
+		std::shared_ptr<libcaer::events::EventPacketContainer> container;
+		std::array<int32_t, IMU6_EVENT + 1> begin; // First event to convert, per packet type.
+	};
+
+	struct Camera {
+		std::unique_ptr<libcaer::devices::davis> device;
+		struct caer_davis_info info;
+		std::string suffix;
+		bool synchronized{false};
+		int64_t lastDeviceTimestamp{INT64_MAX};
+		std::deque<PendingContainer> pending;
+		bool pendingOverflow{false};
+	};
+
+	std::vector<Camera> cameras;
+
+	// Woken by the libcaer threads whenever any camera has new data.
+	std::mutex dataLock;
+	std::condition_variable dataCond;
+	size_t dataAvailable{0};
+
+	EventMerger<MAX_CAMERAS> merger;
+
+public:
+	static void initOutputs(dv::OutputDefinitionList &out) {
+		for (size_t i = 0; i < MAX_CAMERAS; i++) {
+			out.addEventOutput("events" + std::to_string(i));
+			out.addFrameOutput("frames" + std::to_string(i));
+			out.addTriggerOutput("triggers" + std::to_string(i));
+			out.addIMUOutput("imu" + std::to_string(i));
+		}
+
+		out.addEventOutput("merged");
+	}
+
+	static const char *initDescription() {
+		return ("Multiple hardware-synchronized iniVation DAVIS cameras, with synchronization and merged output.");
+	}
+
+	static void initConfigOptions(dv::RuntimeConfig &config) {
+		config.add("serialNumbers",
+			dv::ConfigOption::stringOption(
+				"Comma-separated USB serial numbers of the cameras (1 to 4), in output order.", ""));
+
+		config.add("initialized", dv::ConfigOption::boolOption("sync event received by all cameras", false, true));
+		config.add("resetInitialization",
+			dv::ConfigOption::buttonOption("Resets the initialization state", "Reset init state"));
+
+		config.add("dataMode",
+			dv::ConfigOption::listOption("Camera data mode.", 0, {"Events+Frames", "Events only", "Frames only"}));
+		config.add("imu/Run", dv::ConfigOption::boolOption("Enable the IMUs.", true));
+
+		config.add("system/PacketContainerInterval",
+			dv::ConfigOption::intOption(
+				"Time interval in µs, each sent EventPacketContainer will span this interval (applied on module "
+				"start).",
+				10000, 1, 120 * 1000 * 1000));
+
+		config.add("merged/Enable",
+			dv::ConfigOption::boolOption(
+				"Merge the events of all cameras, in timestamp order, into the 'merged' output.", false));
+		config.add("merged/MaxDelay",
+			dv::ConfigOption::intOption(
+				"A camera not delivering data for this long (in ms) stops holding back the merge.", 50, 1, 10000));
+
+		config.setPriorityOptions({"serialNumbers", "initialized", "resetInitialization", "merged/Enable"});
+	}
+
+	davismulti() {
+		auto serialNumbers = parseSerialNumbers(config.getString("serialNumbers"));
+
+		if (serialNumbers.empty() || (serialNumbers.size() > MAX_CAMERAS)) {
+			throw std::invalid_argument("Specify between 1 and 4 camera serial numbers.");
+		}
+
+		cameras.resize(serialNumbers.size());
+
+		for (size_t i = 0; i < cameras.size(); i++) {
+			auto &camera = cameras[i];
+
+			camera.device = std::make_unique<libcaer::devices::davis>(static_cast<uint16_t>(i), 0, 0, serialNumbers[i]);
+
+			// Initialize per-device log-level to module log-level.
+			camera.device->configSet(CAER_HOST_CONFIG_LOG, CAER_HOST_CONFIG_LOG_LEVEL,
+				static_cast<uint32_t>(dv::LoggerInternal::logLevelNameToInteger(config.getString("logLevel"))));
+
+			camera.info   = camera.device->infoGet();
+			camera.suffix = std::to_string(i);
+
+			if ((i > 0)
+				&& ((camera.info.dvsSizeX != cameras[0].info.dvsSizeX)
+					|| (camera.info.dvsSizeY != cameras[0].info.dvsSizeY))) {
+				throw std::invalid_argument("All cameras must have the same resolution, camera " + std::to_string(i)
+											+ " is " + std::to_string(camera.info.dvsSizeX) + "x"
+											+ std::to_string(camera.info.dvsSizeY) + ", camera 0 "
+											+ std::to_string(cameras[0].info.dvsSizeX) + "x"
+											+ std::to_string(cameras[0].info.dvsSizeY) + ".");
+			}
+
+			auto sourceString = std::string("DAVIS_") + camera.info.deviceSerialNumber;
+
+			outputs.getEventOutput("events" + camera.suffix)
+				.setup(camera.info.dvsSizeX, camera.info.dvsSizeY, sourceString);
+			outputs.getFrameOutput("frames" + camera.suffix)
+				.setup(camera.info.apsSizeX, camera.info.apsSizeY, sourceString);
+			outputs.getTriggerOutput("triggers" + camera.suffix).setup(sourceString);
+			outputs.getIMUOutput("imu" + camera.suffix).setup(sourceString);
+		}
+
+		// Outputs of absent cameras still need valid information.
+		for (size_t i = cameras.size(); i < MAX_CAMERAS; i++) {
+			auto suffix = std::to_string(i);
+
+			outputs.getEventOutput("events" + suffix).setup(1, 1, "None");
+			outputs.getFrameOutput("frames" + suffix).setup(1, 1, "None");
+			outputs.getTriggerOutput("triggers" + suffix).setup("None");
+			outputs.getIMUOutput("imu" + suffix).setup("None");
+		}
+
+		// Merged output: cameras side by side (all checked to have the same resolution above).
+		auto mergedSizeX = static_cast<int32_t>(cameras[0].info.dvsSizeX) * static_cast<int32_t>(cameras.size());
+
+		if (mergedSizeX > INT16_MAX) {
+			throw std::invalid_argument("Merged output would be " + std::to_string(mergedSizeX)
+										+ " pixels wide, more than the maximum of " + std::to_string(INT16_MAX) + ".");
+		}
+
+		outputs.getEventOutput("merged").setup(
+			static_cast<int16_t>(mergedSizeX), cameras[0].info.dvsSizeY, "DAVIS_Merged");
+
+		merger.configure(cameras.size(), cameras[0].info.dvsSizeX);
+
+		for (const auto &output : allOutputs()) {
+			moduleNode.getRelativeNode("outputs/" + output + "/info/")
+				.create<dv::CfgType::LONG>("tsOffset", realTimeClock(), {0, INT64_MAX},
+					dv::CfgFlags::READ_ONLY | dv::CfgFlags::NO_EXPORT,
+					"Time offset of data stream starting point to Unix time in µs.");
+		}
+
+		for (auto &camera : cameras) {
+			// Non-blocking: the mainloop serves all cameras, waking up on data notifications.
+			camera.device->configSet(CAER_HOST_CONFIG_DATAEXCHANGE, CAER_HOST_CONFIG_DATAEXCHANGE_BLOCKING, false);
+			camera.device->configSet(
+				CAER_HOST_CONFIG_DATAEXCHANGE, CAER_HOST_CONFIG_DATAEXCHANGE_START_PRODUCERS, false);
+			camera.device->configSet(CAER_HOST_CONFIG_DATAEXCHANGE, CAER_HOST_CONFIG_DATAEXCHANGE_STOP_PRODUCERS, true);
+
+			camera.device->dataStart(&dataNotifyIncrease, &dataNotifyDecrease, this, &moduleShutdownNotify, this);
+
+			camera.device->sendDefaultConfig();
+
+			camera.device->configSet(CAER_HOST_CONFIG_PACKETS, CAER_HOST_CONFIG_PACKETS_MAX_CONTAINER_INTERVAL,
+				static_cast<uint32_t>(config.getInt("system/PacketContainerInterval")));
+		}
+
+		configSend();
+	}
+
+	~davismulti() override {
+		for (auto &camera : cameras) {
+			camera.device->dataStop();
+		}
+	}
+
+	void configUpdate() override {
+		configSend();
+	}
+
+	void run() override {
+		if (config.getBool("resetInitialization")) {
+			config.setBool("resetInitialization", false);
+			config.setBool("initialized", false);
+
+			for (auto &camera : cameras) {
+				camera.synchronized = false;
+				camera.pending.clear();
+			}
+
+			merger.reset();
+		}
+
+		waitForData();
+
+		for (size_t i = 0; i < cameras.size(); i++) {
+			auto data = cameras[i].device->dataGet();
+
+			if (data && !data->empty()) {
+				handleContainer(i, std::move(data));
+			}
+		}
+
+		if (!config.getBool("merged/Enable")) {
+			merger.reset();
+		}
+		else if (config.getBool("initialized")) {
+			sendMerged();
+		}
+	}
+
+private:
+	static void dataNotifyIncrease(void *p) {
+		auto module = static_cast<davismulti *>(p);
+
+		{
+			std::scoped_lock lock(module->dataLock);
+			module->dataAvailable++;
+		}
+
+		module->dataCond.notify_one();
+	}
+
+	static void dataNotifyDecrease(void *p) {
+		auto module = static_cast<davismulti *>(p);
+
+		std::scoped_lock lock(module->dataLock);
+
+		if (module->dataAvailable > 0) {
+			module->dataAvailable--;
+		}
+	}
+
+	static void moduleShutdownNotify(void *p) {
+		auto module = static_cast<davismulti *>(p);
+
+		// Ensure parent also shuts down (on disconnected device for example).
+		module->moduleNode.putBool("running", false);
+	}
+
+	void waitForData() {
+		std::unique_lock lock(dataLock);
+
+		// Bounded wait, so that configuration changes are still handled.
+		dataCond.wait_for(lock, std::chrono::milliseconds(10), [this]() {
+			return (dataAvailable > 0);
+		});
+	}
+
+	void configSend() {
+		bool runDVS = (config.getString("dataMode").find("Events") != std::string::npos);
+		bool runAPS = (config.getString("dataMode").find("Frames") != std::string::npos);
+		bool runIMU = config.getBool("imu/Run");
+
+		for (auto &camera : cameras) {
+			camera.device->configSet(DAVIS_CONFIG_DVS, DAVIS_CONFIG_DVS_RUN, runDVS);
+			camera.device->configSet(DAVIS_CONFIG_APS, DAVIS_CONFIG_APS_RUN, runAPS);
+			camera.device->configSet(DAVIS_CONFIG_IMU, DAVIS_CONFIG_IMU_RUN_ACCELEROMETER, runIMU);
+			camera.device->configSet(DAVIS_CONFIG_IMU, DAVIS_CONFIG_IMU_RUN_GYROSCOPE, runIMU);
+			camera.device->configSet(DAVIS_CONFIG_IMU, DAVIS_CONFIG_IMU_RUN_TEMPERATURE, runIMU);
+		}
+	}
+
+	void handleContainer(size_t index, std::shared_ptr<libcaer::events::EventPacketContainer> data) {
+		auto &camera = cameras[index];
+
+		PendingContainer entry{std::move(data), {0, 0, 0, 0}};
+
+		auto special = entry.container->getEventPacket(SPECIAL_EVENT);
+
+		if (special) {
+			// Triggers always go out, like in nvp_syncdavis.
+			convertPacket(index, special->getHeaderPointer(), 0);
+		}
+
+		if (special && (TimestampReset::find(special->getHeaderPointer()) >= 0)) {
+			if (!camera.synchronized) {
+				// Data before the reset is in the old timebase, drop it.
+				for (auto type : {POLARITY_EVENT, FRAME_EVENT, IMU6_EVENT}) {
+					if (auto packet = entry.container->getEventPacket(type)) {
+						entry.begin[type]
+							= TimestampReset::split(packet->getHeaderPointer(), camera.lastDeviceTimestamp);
+					}
+				}
+			}
+
+			camera.synchronized = true;
+
+			if (!config.getBool("initialized")) {
+				log.info << "Camera " << camera.info.deviceSerialNumber << " synchronized." << dv::logEnd;
+			}
+		}
+
+		updateLastDeviceTimestamp(camera, *entry.container);
+
+		if (!camera.synchronized) {
+			return;
+		}
+
+		if (!config.getBool("initialized")) {
+			holdContainer(camera, std::move(entry));
+
+			if (allSynchronized()) {
+				startOutput();
+			}
+
+			return;
+		}
+
+		convertContainer(index, entry);
+	}
+
+	void holdContainer(Camera &camera, PendingContainer &&entry) {
+		if (camera.pending.size() >= MAX_PENDING_CONTAINERS) {
+			if (!camera.pendingOverflow) {
+				log.warning << "Camera " << camera.info.deviceSerialNumber
+							<< " is waiting too long for the other cameras to synchronize, dropping its oldest data."
+							<< dv::logEnd;
+				camera.pendingOverflow = true;
+			}
+
+			camera.pending.pop_front();
+		}
+
+		camera.pending.push_back(std::move(entry));
+	}
+
+	bool allSynchronized() const {
+		for (const auto &camera : cameras) {
+			if (!camera.synchronized) {
+				return (false);
+			}
+		}
+
+		return (true);
+	}
+
+	void startOutput() {
+		config.setBool("initialized", true);
+
+		// Cameras are reset together by the sync signal, one offset fits all.
+		auto tsOffset = realTimeClock();
+
+		for (const auto &output : allOutputs()) {
+			moduleNode.getRelativeNode("outputs/" + output + "/info/")
+				.updateReadOnly<dv::CfgType::LONG>("tsOffset", tsOffset);
+		}
+
+		merger.reset();
+
+		for (size_t i = 0; i < cameras.size(); i++) {
+			for (const auto &entry : cameras[i].pending) {
+				convertContainer(i, entry);
+			}
+
+			cameras[i].pending.clear();
+			cameras[i].pendingOverflow = false;
+		}
+	}
+
+	void convertContainer(size_t index, const PendingContainer &entry) {
+		for (auto type : {POLARITY_EVENT, FRAME_EVENT, IMU6_EVENT}) {
+			if (auto packet = entry.container->getEventPacket(type)) {
+				convertPacket(index, packet->getHeaderPointer(), entry.begin[type]);
+			}
+		}
+	}
+
+	void convertPacket(size_t index, caerEventPacketHeaderConst packet, int32_t begin) {
+		const auto &suffix = cameras[index].suffix;
+		bool merge         = config.getBool("merged/Enable");
+
+		switch (caerEventPacketHeaderGetEventType(packet)) {
+			case POLARITY_EVENT: {
+				auto name           = "events" + suffix;
+				auto newObject      = dvModuleOutputAllocate(moduleData, name.c_str());
+				auto newEventPacket = static_cast<dv::EventPacket *>(newObject->obj);
+
+				Aedat4Convert::convert<POLARITY_EVENT>(packet, *newEventPacket, begin);
+
+				if (newEventPacket->elements.size() > 0) {
+					if (merge) {
+						merger.add(index, newEventPacket->elements);
+					}
+
+					dvModuleOutputCommit(moduleData, name.c_str());
+				}
+
+				break;
+			}
+
+			case FRAME_EVENT: {
+				auto name = "frames" + suffix;
+
+				auto frames = reinterpret_cast<caerFrameEventPacketConst>(packet);
+
+				for (int32_t i = begin; i < caerEventPacketHeaderGetEventNumber(packet); i++) {
+					if (!caerFrameEventIsValid(caerFrameEventPacketGetEventConst(frames, i))) {
+						continue;
+					}
+
+					auto newObject = dvModuleOutputAllocate(moduleData, name.c_str());
+					auto newFrame  = static_cast<dv::Frame *>(newObject->obj);
+
+					if (Aedat4Convert::convert<FRAME_EVENT>(packet, i, *newFrame)) {
+						if (merge) {
+							merger.advance(index, newFrame->timestamp);
+						}
+
+						dvModuleOutputCommit(moduleData, name.c_str());
+					}
+				}
+
+				break;
+			}
+
+			case IMU6_EVENT: {
+				auto name         = "imu" + suffix;
+				auto newObject    = dvModuleOutputAllocate(moduleData, name.c_str());
+				auto newIMUPacket = static_cast<dv::IMUPacket *>(newObject->obj);
+
+				Aedat4Convert::convert<IMU6_EVENT>(packet, *newIMUPacket, begin);
+
+				if (newIMUPacket->elements.size() > 0) {
+					if (merge) {
+						merger.advance(index, newIMUPacket->elements.back().timestamp);
+					}
+
+					dvModuleOutputCommit(moduleData, name.c_str());
+				}
+
+				break;
+			}
+
+			case SPECIAL_EVENT: {
+				auto name             = "triggers" + suffix;
+				auto newObject        = dvModuleOutputAllocate(moduleData, name.c_str());
+				auto newTriggerPacket = static_cast<dv::TriggerPacket *>(newObject->obj);
+
+				Aedat4Convert::convert<SPECIAL_EVENT>(packet, *newTriggerPacket);
+
+				if (newTriggerPacket->elements.size() > 0) {
+					dvModuleOutputCommit(moduleData, name.c_str());
+				}
+
+				break;
+			}
+
+			default:
+				break;
+		}
+	}
+
+	void sendMerged() {
+		auto newObject      = dvModuleOutputAllocate(moduleData, "merged");
+		auto newEventPacket = static_cast<dv::EventPacket *>(newObject->obj);
+
+		merger.merge(newEventPacket->elements, std::chrono::milliseconds(config.getInt("merged/MaxDelay")));
+
+		if (newEventPacket->elements.size() > 0) {
+			dvModuleOutputCommit(moduleData, "merged");
+		}
+	}
+
+	static void updateLastDeviceTimestamp(Camera &camera, const libcaer::events::EventPacketContainer &data) {
+		int64_t newest = INT64_MIN;
+
+		for (auto type : {POLARITY_EVENT, FRAME_EVENT, IMU6_EVENT}) {
+			if (auto packet = data.getEventPacket(type)) {
+				newest = std::max(newest, TimestampReset::newest(packet->getHeaderPointer()));
+			}
+		}
+
+		if (newest != INT64_MIN) {
+			camera.lastDeviceTimestamp = newest;
+		}
+	}
+
+	std::vector<std::string> allOutputs() const {
+		std::vector<std::string> names;
+
+		for (size_t i = 0; i < MAX_CAMERAS; i++) {
+			names.push_back("events" + std::to_string(i));
+			names.push_back("frames" + std::to_string(i));
+			names.push_back("triggers" + std::to_string(i));
+			names.push_back("imu" + std::to_string(i));
+		}
+
+		names.push_back("merged");
+
+		return (names);
+	}
+
+	static std::vector<std::string> parseSerialNumbers(const std::string &list) {
+		std::vector<std::string> serialNumbers;
+		std::stringstream stream(list);
+		std::string serialNumber;
+
+		while (std::getline(stream, serialNumber, ',')) {
+			serialNumber.erase(0, serialNumber.find_first_not_of(' '));
+			serialNumber.erase(serialNumber.find_last_not_of(' ') + 1);
+
+			if (!serialNumber.empty()) {
+				serialNumbers.push_back(serialNumber);
+			}
+		}
+
+		return (serialNumbers);
+	}
+
+	static int64_t realTimeClock() {
+		struct timespec tsNow;
+		portable_clock_gettime_realtime(&tsNow);
+
+		return (static_cast<int64_t>(tsNow.tv_sec * 1000000LL) + static_cast<int64_t>(tsNow.tv_nsec / 1000LL));
+	}
+};
+
+registerModuleClass(davismulti)
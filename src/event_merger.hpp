@@ -0,0 +1,156 @@
+#ifndef EVENT_MERGER_HPP
+#define EVENT_MERGER_HPP
+
+#include "dv-sdk/data/event.hpp"
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <vector>
+
+/**
+ * Timestamp-ordered k-way merge of several event streams sharing a timebase.
+ *
+ * Each stream is ordered by itself, so events can only be merged up to the
+ * watermark: the oldest 'newest timestamp' among the streams, as no stream can
+ * produce anything older than that anymore. Streams advance their watermark
+ * with any data (events, IMU, triggers), so a camera without events doesn't
+ * hold the merge back as long as it delivers something. A stream that has not
+ * advanced for 'maxDelay' (host time) is left out of the watermark.
+ *
+ * Events of stream N are shifted right by N * 'xOffset', tiling the cameras.
+ */
+template<size_t MaxStreams>
+class EventMerger {
+public:
+	void configure(size_t streamsNumber, int16_t streamXOffset) {
+		streams = std::min(streamsNumber, MaxStreams);
+		xOffset = streamXOffset;
+
+		reset();
+	}
+
+	void reset() {
+		for (auto &stream : state) {
+			stream.events.clear();
+			stream.position    = 0;
+			stream.watermark   = INT64_MIN;
+			stream.lastAdvance = std::chrono::steady_clock::time_point{};
+		}
+	}
+
+	void add(size_t stream, const dv::cvector<dv::Event> &events) {
+		auto &s = state[stream];
+
+		for (const auto &evt : events) {
+			s.events.emplace_back(evt.timestamp(), static_cast<int16_t>(evt.x() + (stream * xOffset)), evt.y(),
+				evt.polarity());
+		}
+
+		if (!events.empty()) {
+			advance(stream, events.back().timestamp());
+		}
+	}
+
+	void advance(size_t stream, int64_t timestamp) {
+		auto &s = state[stream];
+
+		if (timestamp > s.watermark) {
+			s.watermark   = timestamp;
+			s.lastAdvance = std::chrono::steady_clock::now();
+		}
+	}
+
+	/**
+	 * Append all events up to the current watermark, in timestamp order.
+	 */
+	void merge(dv::cvector<dv::Event> &out, std::chrono::milliseconds maxDelay) {
+		auto now = std::chrono::steady_clock::now();
+
+		int64_t watermark = INT64_MAX;
+		bool anyActive    = false;
+
+		for (size_t i = 0; i < streams; i++) {
+			if ((now - state[i].lastAdvance) > maxDelay) {
+				// Stalled, don't let it hold the others back.
+				continue;
+			}
+
+			watermark = std::min(watermark, state[i].watermark);
+			anyActive = true;
+		}
+
+		if (!anyActive) {
+			return;
+		}
+
+		// Binary min-heap on the head timestamp of each stream, at most MaxStreams entries.
+		std::array<size_t, MaxStreams> heap;
+		size_t heapSize = 0;
+
+		auto headTimestamp = [this](size_t stream) {
+			const auto &s = state[stream];
+			return (s.events[s.position].timestamp());
+		};
+
+		auto heapGreater = [&headTimestamp](size_t a, size_t b) {
+			return (headTimestamp(a) > headTimestamp(b));
+		};
+
+		for (size_t i = 0; i < streams; i++) {
+			if (hasEventUpTo(i, watermark)) {
+				heap[heapSize++] = i;
+			}
+		}
+
+		std::make_heap(heap.begin(), heap.begin() + heapSize, heapGreater);
+
+		while (heapSize > 0) {
+			std::pop_heap(heap.begin(), heap.begin() + heapSize, heapGreater);
+			auto stream = heap[heapSize - 1];
+
+			auto &s = state[stream];
+			out.push_back(s.events[s.position]);
+			s.position++;
+
+			if (hasEventUpTo(stream, watermark)) {
+				std::push_heap(heap.begin(), heap.begin() + heapSize, heapGreater);
+			}
+			else {
+				heapSize--;
+			}
+		}
+
+		for (size_t i = 0; i < streams; i++) {
+			compact(state[i]);
+		}
+	}
+
+private:
+	struct Stream {
+		std::vector<dv::Event> events;
+		size_t position{0};
+		int64_t watermark{INT64_MIN};
+		std::chrono::steady_clock::time_point lastAdvance;
+	};
+
+	std::array<Stream, MaxStreams> state;
+	size_t streams{0};
+	int16_t xOffset{0};
+
+	bool hasEventUpTo(size_t stream, int64_t watermark) const {
+		const auto &s = state[stream];
+		return ((s.position < s.events.size()) && (s.events[s.position].timestamp() <= watermark));
+	}
+
+	static void compact(Stream &s) {
+		// Drop merged events only once they are the majority, to keep this amortized O(1).
+		if (s.position > (s.events.size() / 2)) {
+			s.events.erase(s.events.begin(), s.events.begin() + static_cast<std::ptrdiff_t>(s.position));
+			s.position = 0;
+		}
+	}
+};
+
+#endif // EVENT_MERGER_HPP
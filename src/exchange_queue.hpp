@@ -0,0 +1,344 @@
+#ifndef EXCHANGE_QUEUE_HPP
+#define EXCHANGE_QUEUE_HPP
+
+#include "timestamp_reset.hpp"
+
+#include <libcaercpp/events/packetContainer.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+
+/**
+ * Bounded container queue between the libcaer acquisition thread and the
+ * mainloop, with an explicit policy for when the mainloop falls behind.
+ *
+ * Everything dropped is counted exactly, per event type. Containers carrying a
+ * TIMESTAMP_RESET are never dropped, losing one would lose the sync.
+ *
+ * Capacity and policy can be changed at any time. A smaller capacity takes
+ * effect on the next push, through the policy.
+ *
+ * Each container carries the host time it was taken from libcaer at, so time
+ * spent queued doesn't count as transfer delay (clock drift estimation).
+ *
+ * push() never waits: the producer is libcaer's USB event thread, and while it
+ * is blocked no control transfer (configSet/configGet from the mainloop) can
+ * complete. BLOCK is implemented by the producer instead, see accepts().
+ */
+class ExchangeQueue {
+public:
+	using Container = std::shared_ptr<libcaer::events::EventPacketContainer>;
+
+	struct Entry {
+		Container container; // nullptr if none.
+		int64_t arrivalTime; // Unix time in µs when taken from libcaer.
+	};
+
+	enum class Policy {
+		// Stop taking containers from libcaer while full, so libcaer's own ring
+		// fills up and drops the newest ones (not counted here).
+		BLOCK,
+		DROP_OLDEST,
+		DROP_NEWEST,
+		// Strip frames from queued and incoming containers, then allow events-only
+		// containers up to twice the capacity before dropping the oldest.
+		DROP_FRAMES_FIRST,
+	};
+
+	struct Drops {
+		int64_t containers; // Containers dropped entirely.
+		int64_t events;     // Polarity events.
+		int64_t frames;     // Frames, also those stripped from kept containers.
+		int64_t imu;        // IMU samples.
+		int64_t special;    // Triggers and other special events.
+		int64_t lastTime;   // Unix time of the last drop in µs, 0 if none.
+	};
+
+	static Policy parsePolicy(const std::string &name) {
+		if (name == "Block") {
+			return (Policy::BLOCK);
+		}
+		if (name == "DropOldest") {
+			return (Policy::DROP_OLDEST);
+		}
+		if (name == "DropFramesFirst") {
+			return (Policy::DROP_FRAMES_FIRST);
+		}
+
+		return (Policy::DROP_NEWEST);
+	}
+
+	void configure(size_t newCapacity, Policy newPolicy) {
+		std::scoped_lock lock(mutex);
+
+		if ((newCapacity == capacity) && (newPolicy == policy)) {
+			return;
+		}
+
+		capacity = std::max<size_t>(newCapacity, 1);
+		policy   = newPolicy;
+	}
+
+	/**
+	 * Accept containers again, after stop().
+	 */
+	void start() {
+		std::scoped_lock lock(mutex);
+
+		stopped = false;
+	}
+
+	/**
+	 * Release a waiting consumer and discard everything, before stopping acquisition.
+	 */
+	void stop() {
+		std::scoped_lock lock(mutex);
+
+		stopped = true;
+		queue.clear();
+
+		notEmpty.notify_all();
+	}
+
+	/**
+	 * Whether the producer should take another container from libcaer: false
+	 * only with BLOCK and a full queue.
+	 */
+	bool accepts() const {
+		std::scoped_lock lock(mutex);
+
+		return ((policy != Policy::BLOCK) || stopped || (queue.size() < capacity));
+	}
+
+	/**
+	 * Producer side. Never waits.
+	 */
+	void push(Container container, int64_t arrivalTime) {
+		std::scoped_lock lock(mutex);
+
+		if (stopped) {
+			// Shutting down, not delivered anymore.
+			return;
+		}
+
+		switch (policy) {
+			case Policy::BLOCK:
+				// Producers check accepts() first. A container taken anyway (policy
+				// or capacity just changed) is kept, it's out of libcaer already.
+				break;
+
+			case Policy::DROP_NEWEST:
+				if (queue.size() >= capacity) {
+					if (!carriesReset(*container)) {
+						drop(*container);
+						return;
+					}
+
+					dropQueued(false);
+				}
+				break;
+
+			case Policy::DROP_OLDEST:
+				if (!makeRoom(capacity, *container)) {
+					return;
+				}
+				break;
+
+			case Policy::DROP_FRAMES_FIRST:
+				if (queue.size() >= capacity) {
+					for (auto &queued : queue) {
+						stripFrames(queued.container);
+					}
+
+					stripFrames(container);
+
+					if (!hasData(*container)) {
+						return;
+					}
+
+					if (!makeRoom(2 * capacity, *container)) {
+						return;
+					}
+				}
+				break;
+		}
+
+		queue.push_back(Entry{std::move(container), arrivalTime});
+		highWater = std::max(highWater, queue.size());
+
+		notEmpty.notify_one();
+	}
+
+	/**
+	 * Consumer side, mainloop. Waits up to 'timeout' for data, a nullptr
+	 * container if none.
+	 */
+	Entry pop(std::chrono::milliseconds timeout) {
+		std::unique_lock lock(mutex);
+
+		if (!notEmpty.wait_for(lock, timeout, [this] {
+				return (stopped || !queue.empty());
+			})) {
+			return (Entry{nullptr, 0});
+		}
+
+		if (queue.empty()) {
+			return (Entry{nullptr, 0});
+		}
+
+		auto entry = std::move(queue.front());
+		queue.pop_front();
+
+		return (entry);
+	}
+
+	Drops drops() const {
+		std::scoped_lock lock(mutex);
+
+		return (dropped);
+	}
+
+	/**
+	 * Most containers queued at once since the last call.
+	 */
+	size_t takeHighWater() {
+		std::scoped_lock lock(mutex);
+
+		auto result = highWater;
+		highWater   = queue.size();
+
+		return (result);
+	}
+
+private:
+	mutable std::mutex mutex;
+	std::condition_variable notEmpty;
+	std::deque<Entry> queue;
+	size_t capacity{64};
+	Policy policy{Policy::DROP_NEWEST};
+	bool stopped{false};
+	size_t highWater{0};
+	Drops dropped{0, 0, 0, 0, 0, 0};
+
+	/**
+	 * Drop the oldest queued containers until there is room below 'limit'. If
+	 * only resets are left, the incoming container is dropped instead; returns
+	 * false if that happened.
+	 */
+	bool makeRoom(size_t limit, const libcaer::events::EventPacketContainer &incoming) {
+		while ((queue.size() >= limit) && dropQueued(true)) {
+		}
+
+		if ((queue.size() >= limit) && !carriesReset(incoming)) {
+			drop(incoming);
+			return (false);
+		}
+
+		return (true);
+	}
+
+	/**
+	 * Drop the oldest (or newest) queued container that doesn't carry a reset.
+	 */
+	bool dropQueued(bool oldest) {
+		auto droppable = [](const Entry &entry) {
+			return (!carriesReset(*entry.container));
+		};
+
+		if (oldest) {
+			auto found = std::find_if(queue.begin(), queue.end(), droppable);
+			if (found == queue.end()) {
+				return (false);
+			}
+
+			drop(*found->container);
+			queue.erase(found);
+		}
+		else {
+			auto found = std::find_if(queue.rbegin(), queue.rend(), droppable);
+			if (found == queue.rend()) {
+				return (false);
+			}
+
+			drop(*found->container);
+			queue.erase(std::next(found).base());
+		}
+
+		return (true);
+	}
+
+	void drop(const libcaer::events::EventPacketContainer &container) {
+		dropped.containers++;
+		dropped.events += validEvents(container, POLARITY_EVENT);
+		dropped.frames += validEvents(container, FRAME_EVENT);
+		dropped.imu += validEvents(container, IMU6_EVENT);
+		dropped.special += validEvents(container, SPECIAL_EVENT);
+
+		markDrop();
+	}
+
+	void stripFrames(Container &container) {
+		auto frames = validEvents(*container, FRAME_EVENT);
+		if (frames == 0) {
+			return;
+		}
+
+		// Same layout (index == type), without the frames.
+		auto stripped = std::make_shared<libcaer::events::EventPacketContainer>();
+
+		for (int32_t i = 0; i < static_cast<int32_t>(container->size()); i++) {
+			stripped->addEventPacket((i == FRAME_EVENT) ? (nullptr) : (container->getEventPacket(i)));
+		}
+
+		container = std::move(stripped);
+
+		dropped.frames += frames;
+		markDrop();
+	}
+
+	void markDrop() {
+		dropped.lastTime
+			= std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::system_clock::now().time_since_epoch())
+				  .count();
+	}
+
+	static int64_t validEvents(const libcaer::events::EventPacketContainer &container, int32_t type) {
+		if (type >= static_cast<int32_t>(container.size())) {
+			return (0);
+		}
+
+		auto packet = container.getEventPacket(type);
+
+		return ((packet) ? (packet->getEventValid()) : (0));
+	}
+
+	static bool hasData(const libcaer::events::EventPacketContainer &container) {
+		for (int32_t i = 0; i < static_cast<int32_t>(container.size()); i++) {
+			auto packet = container.getEventPacket(i);
+
+			if (packet && (packet->getEventNumber() > 0)) {
+				return (true);
+			}
+		}
+
+		return (false);
+	}
+
+	static bool carriesReset(const libcaer::events::EventPacketContainer &container) {
+		if (static_cast<int32_t>(container.size()) <= SPECIAL_EVENT) {
+			return (false);
+		}
+
+		auto special = container.getEventPacket(SPECIAL_EVENT);
+
+		return (special && (TimestampReset::find(special->getHeaderPointer()) >= 0));
+	}
+};
+
+#endif // EXCHANGE_QUEUE_HPP
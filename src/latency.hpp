@@ -0,0 +1,145 @@
+#ifndef LATENCY_HPP
+#define LATENCY_HPP
+
+#include "dv-sdk/module.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <string>
+
+/**
+ * Fixed-size log-linear histogram for latencies in µs.
+ * Values below 32 are exact, above that every power of two is split into
+ * 16 buckets (~6% resolution). Recording never allocates.
+ */
+class LatencyHistogram {
+public:
+	static constexpr size_t SUB_BUCKETS = 16;
+	static constexpr size_t BUCKETS     = 40 * SUB_BUCKETS;
+
+	void record(int64_t value) {
+		if (value < 0) {
+			value = 0;
+		}
+
+		counts[bucketIndex(static_cast<uint64_t>(value))]++;
+		total++;
+		maxValue = std::max(maxValue, value);
+	}
+
+	void reset() {
+		counts.fill(0);
+		total    = 0;
+		maxValue = 0;
+	}
+
+	size_t count() const {
+		return (total);
+	}
+
+	int64_t max() const {
+		return (maxValue);
+	}
+
+	/**
+	 * Lower bound of the bucket holding the given percentile (0-100).
+	 */
+	int64_t percentile(double pct) const {
+		if (total == 0) {
+			return (0);
+		}
+
+		auto target = static_cast<size_t>((pct / 100.0) * static_cast<double>(total));
+		if (target >= total) {
+			target = total - 1;
+		}
+
+		size_t cumulative = 0;
+
+		for (size_t i = 0; i < BUCKETS; i++) {
+			cumulative += counts[i];
+
+			if (cumulative > target) {
+				return (std::min(bucketValue(i), maxValue));
+			}
+		}
+
+		return (maxValue);
+	}
+
+private:
+	std::array<uint32_t, BUCKETS> counts{};
+	size_t total{0};
+	int64_t maxValue{0};
+
+	static size_t bucketIndex(uint64_t value) {
+		if (value < (2 * SUB_BUCKETS)) {
+			return (static_cast<size_t>(value));
+		}
+
+		auto msb   = static_cast<size_t>(63 - __builtin_clzll(value));
+		auto shift = msb - 4;
+		auto index = ((shift + 1) * SUB_BUCKETS) + static_cast<size_t>((value >> shift) - SUB_BUCKETS);
+
+		return (std::min(index, BUCKETS - 1));
+	}
+
+	static int64_t bucketValue(size_t index) {
+		if (index < (2 * SUB_BUCKETS)) {
+			return (static_cast<int64_t>(index));
+		}
+
+		auto shift = (index / SUB_BUCKETS) - 1;
+
+		return (static_cast<int64_t>(((index % SUB_BUCKETS) + SUB_BUCKETS) << shift));
+	}
+};
+
+/**
+ * Latency statistics for one output: age of the newest committed element
+ * (host real-time at commit minus tsOffset plus device timestamp), time from
+ * dataGet() return to commit, and pure conversion time.
+ */
+class OutputLatency {
+public:
+	LatencyHistogram age;
+	LatencyHistogram pipeline;
+	LatencyHistogram conversion;
+
+	static void createAttributes(dv::Config::Node node) {
+		for (const auto &histogram : {"age", "pipeline", "conversion"}) {
+			for (const auto &stat : {"P50", "P90", "P99", "Max"}) {
+				node.create<dv::CfgType::LONG>(std::string(histogram) + stat, 0, {0, INT64_MAX},
+					dv::CfgFlags::READ_ONLY | dv::CfgFlags::NO_EXPORT,
+					std::string("Latency ") + histogram + " " + stat + " over the last interval (in µs).");
+			}
+		}
+	}
+
+	/**
+	 * Write out percentiles and start a new measurement window.
+	 * Nothing is published for windows without data.
+	 */
+	void publish(dv::Config::Node node) {
+		publishHistogram(node, "age", age);
+		publishHistogram(node, "pipeline", pipeline);
+		publishHistogram(node, "conversion", conversion);
+	}
+
+private:
+	static void publishHistogram(dv::Config::Node node, const std::string &name, LatencyHistogram &histogram) {
+		if (histogram.count() == 0) {
+			return;
+		}
+
+		node.updateReadOnly<dv::CfgType::LONG>(name + "P50", histogram.percentile(50));
+		node.updateReadOnly<dv::CfgType::LONG>(name + "P90", histogram.percentile(90));
+		node.updateReadOnly<dv::CfgType::LONG>(name + "P99", histogram.percentile(99));
+		node.updateReadOnly<dv::CfgType::LONG>(name + "Max", histogram.max());
+
+		histogram.reset();
+	}
+};
+
+#endif // LATENCY_HPP
@@ -0,0 +1,295 @@
+#ifndef PRESYNC_BUFFER_HPP
+#define PRESYNC_BUFFER_HPP
+
+#include "dv-sdk/module.h"
+
+#include "aedat4_convert.hpp"
+#include "aedat4_converter.hpp"
+
+#include <libcaercpp/events/imu6.hpp>
+#include <libcaercpp/events/polarity.hpp>
+
+#include <algorithm>
+#include <functional>
+#include <vector>
+
+/**
+ * Fixed-capacity ring, overwriting the oldest element when full.
+ * Slots are allocated once, filling one only reuses the slot's memory.
+ */
+template<typename T>
+class FixedRing {
+public:
+	void resize(size_t capacity) {
+		slots.resize(capacity);
+		clear();
+	}
+
+	size_t capacity() const {
+		return (slots.size());
+	}
+
+	size_t size() const {
+		return (count);
+	}
+
+	void clear() {
+		head  = 0;
+		count = 0;
+	}
+
+	/**
+	 * Slot that the next push() will make visible, can be filled in place.
+	 */
+	T &next() {
+		return (slots[head]);
+	}
+
+	void push() {
+		head  = (head + 1) % slots.size();
+		count = std::min(count + 1, slots.size());
+	}
+
+	/**
+	 * Element 'index', 0 being the oldest.
+	 */
+	const T &operator[](size_t index) const {
+		return (slots[(head + slots.size() - count + index) % slots.size()]);
+	}
+
+private:
+	std::vector<T> slots;
+	size_t head{0};
+	size_t count{0};
+};
+
+/**
+ * Keeps the most recent polarity events, frames and IMU samples seen before the
+ * sync TIMESTAMP_RESET, so they can still be sent out once it arrives.
+ *
+ * Memory is bounded by the capacities given to configure(), which is the only
+ * place that allocates. On flush(), data from the last 'window' µs before the
+ * reset is re-based onto the new timebase: the last device timestamp before the
+ * reset becomes 0, earlier data gets negative timestamps (tsOffset is taken at
+ * the sync).
+ */
+class PreSyncBuffer {
+public:
+	void configure(size_t maxEvents, size_t maxFrames, size_t maxIMUSamples, size_t maxFramePixels) {
+		if ((maxEvents == events.capacity()) && (maxFrames == frames.capacity())
+			&& (maxIMUSamples == imuSamples.capacity()) && (maxFramePixels == framePixels)) {
+			return;
+		}
+
+		events.resize(maxEvents);
+		frames.resize(maxFrames);
+		imuSamples.resize(maxIMUSamples);
+
+		framePixels = maxFramePixels;
+
+		for (size_t i = 0; i < maxFrames; i++) {
+			frames.next().pixels.reserve(framePixels);
+			frames.push();
+		}
+
+		clear();
+	}
+
+	void clear() {
+		events.clear();
+		frames.clear();
+		imuSamples.clear();
+		newestTimestamp = INT64_MIN;
+	}
+
+	/**
+	 * Add the events with index in [begin, end) of a packet, only those inside
+	 * 'roi' (mapped to its coordinates) if given.
+	 */
+	void addPolarity(caerEventPacketHeaderConst packet, int32_t begin = 0, int32_t end = INT32_MAX,
+		const Aedat4Convert::EventROI *roi = nullptr) {
+		if (events.capacity() == 0) {
+			return;
+		}
+
+		const libcaer::events::PolarityEventPacket polarity(const_cast<caerEventPacketHeader>(packet), false);
+
+		end = std::min(end, polarity.getEventNumber());
+
+		for (int32_t i = begin; i < end; i++) {
+			const auto &evt = polarity[i];
+
+			if (!evt.isValid()) {
+				continue;
+			}
+
+			if (roi != nullptr) {
+				if (!roi->contains(evt.getX(), evt.getY())) {
+					continue;
+				}
+
+				events.next() = dv::Event(
+					evt.getTimestamp64(polarity), roi->mapX(evt.getX()), roi->mapY(evt.getY()), evt.getPolarity());
+				events.push();
+				continue;
+			}
+
+			events.next() = dv::Event(evt.getTimestamp64(polarity), evt.getX(), evt.getY(), evt.getPolarity());
+			events.push();
+		}
+
+		if (events.size() > 0) {
+			newestTimestamp = std::max(newestTimestamp, events[events.size() - 1].timestamp());
+		}
+	}
+
+	/**
+	 * Frames are converted with 'options' (pool, demosaic), as live ones are.
+	 */
+	void addFrames(caerEventPacketHeaderConst packet, int32_t begin = 0, int32_t end = INT32_MAX,
+		const dvConvertOptions &options = dvConvertOptions{}) {
+		if (frames.capacity() == 0) {
+			return;
+		}
+
+		end = std::min(end, caerEventPacketHeaderGetEventNumber(packet));
+
+		for (int32_t i = begin; i < end; i++) {
+			auto &frame = frames.next();
+
+			// Frames larger than the sensor can't occur, so this never reallocates.
+			if (Aedat4Convert::convert<FRAME_EVENT>(packet, i, frame, options.framePool, options.demosaic)) {
+				frames.push();
+
+				newestTimestamp = std::max(newestTimestamp, frame.timestamp);
+			}
+		}
+	}
+
+	void addIMU6(caerEventPacketHeaderConst packet, int32_t begin = 0, int32_t end = INT32_MAX) {
+		if (imuSamples.capacity() == 0) {
+			return;
+		}
+
+		const libcaer::events::IMU6EventPacket imu6(const_cast<caerEventPacketHeader>(packet), false);
+
+		end = std::min(end, imu6.getEventNumber());
+
+		for (int32_t i = begin; i < end; i++) {
+			const auto &evt = imu6[i];
+
+			if (!evt.isValid()) {
+				continue;
+			}
+
+			auto &imu          = imuSamples.next();
+			imu.timestamp      = evt.getTimestamp64(imu6);
+			imu.temperature    = evt.getTemp();
+			imu.accelerometerX = evt.getAccelX();
+			imu.accelerometerY = evt.getAccelY();
+			imu.accelerometerZ = evt.getAccelZ();
+			imu.gyroscopeX     = evt.getGyroX();
+			imu.gyroscopeY     = evt.getGyroY();
+			imu.gyroscopeZ     = evt.getGyroZ();
+			imuSamples.push();
+
+			newestTimestamp = std::max(newestTimestamp, imu.timestamp);
+		}
+	}
+
+	/**
+	 * Send out buffered data from the 'window' µs before 'resetTimestamp', the
+	 * last device timestamp seen before the reset, re-based onto it, and clear.
+	 * INT64_MIN if unknown, the newest buffered timestamp is used then.
+	 * With 'frameStatistics', it's called for each frame sent, as the
+	 * conversion does for live frames.
+	 */
+	void flush(dvModuleData moduleData, int64_t window, int64_t resetTimestamp,
+		const std::function<void(int64_t timestamp, const Aedat4Convert::FrameStatistics &statistics)>
+			&frameStatistics
+		= nullptr) {
+		if (newestTimestamp == INT64_MIN) {
+			return;
+		}
+
+		auto base   = std::max(resetTimestamp, newestTimestamp);
+		auto oldest = base - window;
+
+		if (events.size() > 0) {
+			auto newObject      = dvModuleOutputAllocate(moduleData, "events");
+			auto newEventPacket = static_cast<dv::EventPacket *>(newObject->obj);
+
+			newEventPacket->elements.reserve(events.size());
+
+			for (size_t i = 0; i < events.size(); i++) {
+				const auto &evt = events[i];
+
+				if (evt.timestamp() >= oldest) {
+					newEventPacket->elements.emplace_back(
+						evt.timestamp() - base, evt.x(), evt.y(), evt.polarity());
+				}
+			}
+
+			if (newEventPacket->elements.size() > 0) {
+				dvModuleOutputCommit(moduleData, "events");
+			}
+		}
+
+		for (size_t i = 0; i < frames.size(); i++) {
+			const auto &frame = frames[i];
+
+			if (frame.timestamp < oldest) {
+				continue;
+			}
+
+			auto newObject = dvModuleOutputAllocate(moduleData, "frames");
+			auto newFrame  = static_cast<dv::Frame *>(newObject->obj);
+
+			*newFrame = frame;
+
+			newFrame->timestamp -= base;
+			newFrame->timestampStartOfFrame -= base;
+			newFrame->timestampStartOfExposure -= base;
+			newFrame->timestampEndOfExposure -= base;
+			newFrame->timestampEndOfFrame -= base;
+
+			dvModuleOutputCommit(moduleData, "frames");
+
+			if (frameStatistics) {
+				Aedat4Convert::FrameStatistics statistics;
+				statistics.add(frame);
+
+				frameStatistics(frame.timestamp - base, statistics);
+			}
+		}
+
+		if (imuSamples.size() > 0) {
+			auto newObject    = dvModuleOutputAllocate(moduleData, "imu");
+			auto newIMUPacket = static_cast<dv::IMUPacket *>(newObject->obj);
+
+			newIMUPacket->elements.reserve(imuSamples.size());
+
+			for (size_t i = 0; i < imuSamples.size(); i++) {
+				if (imuSamples[i].timestamp >= oldest) {
+					newIMUPacket->elements.push_back(imuSamples[i]);
+					newIMUPacket->elements.back().timestamp -= base;
+				}
+			}
+
+			if (newIMUPacket->elements.size() > 0) {
+				dvModuleOutputCommit(moduleData, "imu");
+			}
+		}
+
+		clear();
+	}
+
+private:
+	FixedRing<dv::Event> events;
+	FixedRing<dv::Frame> frames;
+	FixedRing<dv::IMU> imuSamples;
+	size_t framePixels{0};
+	int64_t newestTimestamp{INT64_MIN};
+};
+
+#endif // PRESYNC_BUFFER_HPP
@@ -0,0 +1,171 @@
+#ifndef RATE_GOVERNOR_HPP
+#define RATE_GOVERNOR_HPP
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+
+/**
+ * Closed-loop event rate limiting through the DAVIS FPGA filters.
+ *
+ * The rate measured after the device (so after the filters) is compared to the
+ * target once per window, and a single filter strength from 0 to 1 is moved by
+ * the log of their ratio, with a deadband to not chase noise. The strength is
+ * spread over the available filters as consecutive stages, weakest first:
+ *
+ *   1. background-activity filter, correlation time shrinking down to 250 µs,
+ *   2. refractory period filter, period growing up to 100 ms,
+ *   3. skip filter, from skipping 1 in 256 events down to 1 in 2.
+ *
+ * Each stage starts from the configured settings, and strength 0 gives exactly
+ * the configured settings back.
+ */
+class RateGovernor {
+public:
+	struct Settings {
+		bool noiseEnable;
+		int32_t noiseTime; // 250 µs units.
+		bool rateEnable;
+		int32_t rateTime; // 250 µs units.
+		bool skipEnable;
+		int32_t skipEvery;
+
+		bool operator==(const Settings &rhs) const {
+			return ((noiseEnable == rhs.noiseEnable) && (noiseTime == rhs.noiseTime) && (rateEnable == rhs.rateEnable)
+					&& (rateTime == rhs.rateTime) && (skipEnable == rhs.skipEnable) && (skipEvery == rhs.skipEvery));
+		}
+
+		bool operator!=(const Settings &rhs) const {
+			return (!(*this == rhs));
+		}
+	};
+
+	/**
+	 * Start over from the configured settings, strength 0.
+	 */
+	void reset(const Settings &configured, bool hasActivityFilters, bool hasSkipFilter) {
+		base        = configured;
+		current     = configured;
+		hasActivity = hasActivityFilters;
+		hasSkip     = hasSkipFilter;
+
+		strength     = 0;
+		windowEvents = 0;
+		rate         = 0;
+	}
+
+	void addEvents(int64_t events) {
+		windowEvents += events;
+	}
+
+	/**
+	 * Close a measurement window of the given duration (µs), against a target
+	 * rate in events/s. Returns true and fills 'result' if the device settings
+	 * should change.
+	 */
+	bool update(int64_t windowDuration, double targetRate, Settings &result) {
+		if (windowDuration <= 0) {
+			windowEvents = 0;
+			return (false);
+		}
+
+		rate         = static_cast<double>(windowEvents) * 1000000.0 / static_cast<double>(windowDuration);
+		windowEvents = 0;
+
+		double ratio = (std::max(rate, 1.0)) / std::max(targetRate, 1.0);
+
+		if ((ratio > (1 + DEADBAND)) || (ratio < (1 - DEADBAND))) {
+			strength = std::clamp(strength + (GAIN * std::log2(ratio)), 0.0, 1.0);
+		}
+
+		auto settings = map(strength);
+
+		if (settings == current) {
+			return (false);
+		}
+
+		current = settings;
+		result  = settings;
+
+		return (true);
+	}
+
+	const Settings &getConfigured() const {
+		return (base);
+	}
+
+	double getStrength() const {
+		return (strength);
+	}
+
+	double getRate() const {
+		return (rate);
+	}
+
+private:
+	static constexpr double DEADBAND = 0.1;
+	static constexpr double GAIN     = 0.05;
+
+	static constexpr int32_t NOISE_TIME_MIN = 1;
+	static constexpr int32_t NOISE_TIME_MAX = (0x01 << 12) - 1;
+	static constexpr int32_t RATE_TIME_MAX  = 400;
+	static constexpr int32_t SKIP_EVERY_MAX = (0x01 << 8) - 1;
+
+	Settings base{};
+	Settings current{};
+	bool hasActivity{false};
+	bool hasSkip{false};
+
+	double strength{0};
+	int64_t windowEvents{0};
+	double rate{0};
+
+	Settings map(double s) const {
+		Settings settings = base;
+
+		int stages = ((hasActivity) ? (2) : (0)) + ((hasSkip) ? (1) : (0));
+		if ((stages == 0) || (s <= 0)) {
+			return (settings);
+		}
+
+		double position = s * stages;
+		int stage       = 0;
+
+		if (hasActivity) {
+			if (auto t = stageProgress(position, stage++); t > 0) {
+				int32_t from         = (base.noiseEnable) ? (std::max(base.noiseTime, 1)) : (NOISE_TIME_MAX);
+				settings.noiseEnable = true;
+				settings.noiseTime   = std::min(from, interpolate(from, NOISE_TIME_MIN, t));
+			}
+
+			if (auto t = stageProgress(position, stage++); t > 0) {
+				int32_t from        = (base.rateEnable) ? (std::max(base.rateTime, 1)) : (1);
+				settings.rateEnable = true;
+				settings.rateTime   = std::max(from, interpolate(from, RATE_TIME_MAX, t));
+			}
+		}
+
+		if (hasSkip) {
+			if (auto t = stageProgress(position, stage++); t > 0) {
+				int32_t from        = (base.skipEnable) ? (std::max(base.skipEvery, 1)) : (SKIP_EVERY_MAX);
+				settings.skipEnable = true;
+				settings.skipEvery  = std::min(from, interpolate(from, 1, t));
+			}
+		}
+
+		return (settings);
+	}
+
+	static double stageProgress(double position, int stage) {
+		return (std::clamp(position - stage, 0.0, 1.0));
+	}
+
+	// Geometric, filter times act multiplicatively on the rate.
+	static int32_t interpolate(int32_t from, int32_t to, double t) {
+		double value = static_cast<double>(from) * std::pow(static_cast<double>(to) / static_cast<double>(from), t);
+
+		return (static_cast<int32_t>(std::lround(value)));
+	}
+};
+
+#endif // RATE_GOVERNOR_HPP
@@ -0,0 +1,358 @@
+#define DV_API_OPENCV_SUPPORT 0
+
+#include "aedat4_converter.hpp"
+#include "raw_capture.hpp"
+#include "thread_pool.hpp"
+
+#include <libcaer/events/special.h>
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+/**
+ * Offline conversion of raw libcaer captures (see raw_capture.hpp) to AEDAT4,
+ * with the same conversion and output streams as the syncdavis module.
+ *
+ * The capture is memory-mapped and walked sequentially; chunks of containers
+ * are converted and serialized in parallel, then written in capture order.
+ * At most a fixed number of chunks is in flight, and mapped pages are released
+ * once written, so memory use does not depend on the capture size.
+ */
+
+// AEDAT4 stream IDs, same order as the module outputs.
+enum StreamID : int32_t {
+	EVENTS   = 0,
+	FRAMES   = 1,
+	TRIGGERS = 2,
+	IMU      = 3,
+};
+
+struct Chunk {
+	std::vector<RawCapture::ContainerView> containers;
+	bool waitForSync{false};
+};
+
+static const char AEDAT4_VERSION[] = "#!AER-DAT4.0\r\n";
+
+static void usage(const char *name) {
+	std::cerr << "Usage: " << name << " [options] <input.raw> <output.aedat4>" << std::endl
+			  << "Options:" << std::endl
+			  << "  -j <threads>     Conversion threads (default: hardware concurrency)." << std::endl
+			  << "  -c <containers>  Containers converted per chunk (default: 64)." << std::endl
+			  << "  -s               Drop data before the first TIMESTAMP_RESET, like the module does."
+			  << std::endl;
+}
+
+static bool hasTimestampReset(caerEventPacketHeaderConst special) {
+	if (special == nullptr) {
+		return (false);
+	}
+
+	auto specialPacket = reinterpret_cast<caerSpecialEventPacketConst>(special);
+
+	for (int32_t i = 0; i < caerEventPacketHeaderGetEventNumber(special); i++) {
+		auto event = caerSpecialEventPacketGetEventConst(specialPacket, i);
+
+		if (caerSpecialEventIsValid(event) && (caerSpecialEventGetType(event) == TIMESTAMP_RESET)) {
+			return (true);
+		}
+	}
+
+	return (false);
+}
+
+/**
+ * Estimate the offset from device to Unix time, using the host arrival time of
+ * the first container with events (the module uses the time of the sync).
+ */
+static int64_t estimateTimestampOffset(RawCapture::Reader &reader, bool waitForSync) {
+	RawCapture::ContainerView view;
+	int64_t offset = 0;
+
+	while (reader.next(view)) {
+		if (waitForSync) {
+			waitForSync = !hasTimestampReset(view.packets[SPECIAL_EVENT]);
+			continue;
+		}
+
+		for (auto packet : view.packets) {
+			if ((packet == nullptr) || (caerEventPacketHeaderGetEventNumber(packet) <= 0)) {
+				continue;
+			}
+
+			auto last = caerGenericEventGetEvent(packet, caerEventPacketHeaderGetEventNumber(packet) - 1);
+
+			offset = view.hostTime - caerGenericEventGetTimestamp64(last, packet);
+			break;
+		}
+
+		if (offset != 0) {
+			break;
+		}
+	}
+
+	reader.rewind();
+
+	return (offset);
+}
+
+static std::string streamInfo(int32_t id, const char *name, const char *identifier, const char *description,
+	int16_t sizeX, int16_t sizeY, const std::string &source, int64_t tsOffset) {
+	auto path = "/outInfo/" + std::to_string(id) + "/";
+
+	std::string xml;
+
+	xml += "<node name=\"" + std::to_string(id) + "\" path=\"" + path + "\">";
+	xml += "<attr key=\"compression\" type=\"string\">NONE</attr>";
+	xml += "<attr key=\"originalModuleName\" type=\"string\">capture</attr>";
+	xml += "<attr key=\"originalOutputName\" type=\"string\">" + std::string(name) + "</attr>";
+	xml += "<attr key=\"typeDescription\" type=\"string\">" + std::string(description) + "</attr>";
+	xml += "<attr key=\"typeIdentifier\" type=\"string\">" + std::string(identifier) + "</attr>";
+	xml += "<node name=\"info\" path=\"" + path + "info/\">";
+	if (sizeX > 0) {
+		xml += "<attr key=\"sizeX\" type=\"int\">" + std::to_string(sizeX) + "</attr>";
+		xml += "<attr key=\"sizeY\" type=\"int\">" + std::to_string(sizeY) + "</attr>";
+	}
+	xml += "<attr key=\"source\" type=\"string\">" + source + "</attr>";
+	xml += "<attr key=\"tsOffset\" type=\"long\">" + std::to_string(tsOffset) + "</attr>";
+	xml += "</node></node>";
+
+	return (xml);
+}
+
+static void writeHeader(std::ofstream &output, const RawCapture::FileHeader &header, int64_t tsOffset) {
+	auto source = std::string("DAVIS_") + std::string(header.serialNumber, strnlen(header.serialNumber, 8));
+
+	std::string infoNode = "<dv version=\"2.0\"><node name=\"outInfo\" path=\"/outInfo/\">";
+	infoNode += streamInfo(EVENTS, "events", dv::EventPacket::TableType::identifier,
+		"Array of events (polarity ON/OFF).", header.dvsSizeX, header.dvsSizeY, source, tsOffset);
+	infoNode += streamInfo(FRAMES, "frames", dv::Frame::TableType::identifier, "Standard frame (8-bit image).",
+		header.apsSizeX, header.apsSizeY, source, tsOffset);
+	infoNode += streamInfo(TRIGGERS, "triggers", dv::TriggerPacket::TableType::identifier,
+		"Array of triggers (special events).", 0, 0, source, tsOffset);
+	infoNode += streamInfo(IMU, "imu", dv::IMUPacket::TableType::identifier,
+		"Inertial Measurement Unit data samples.", 0, 0, source, tsOffset);
+	infoNode += "</node></dv>";
+
+	// IOHeader table: compression (NONE) and dataTablePosition (-1, no table)
+	// are left at their defaults, only the info node is set.
+	flatbuffers::FlatBufferBuilder builder(infoNode.size() + 64);
+
+	auto infoNodeOffset = builder.CreateString(infoNode);
+	auto start          = builder.StartTable();
+	builder.AddOffset(8, infoNodeOffset);
+	flatbuffers::Offset<void> root(builder.EndTable(start));
+
+	builder.FinishSizePrefixed(root, "IOHE");
+
+	output.write(AEDAT4_VERSION, sizeof(AEDAT4_VERSION) - 1);
+	output.write(reinterpret_cast<const char *>(builder.GetBufferPointer()), builder.GetSize());
+}
+
+template<typename ObjectType>
+static void serializePacket(
+	std::vector<uint8_t> &out, flatbuffers::FlatBufferBuilder &builder, int32_t streamID, const ObjectType &object) {
+	builder.Clear();
+	builder.Finish(ObjectType::TableType::Pack(builder, &object), ObjectType::TableType::identifier);
+
+	// AEDAT4 packet header: stream ID and size, then the flatbuffer.
+	int32_t packetHeader[2] = {streamID, static_cast<int32_t>(builder.GetSize())};
+
+	auto headerBytes = reinterpret_cast<const uint8_t *>(packetHeader);
+	out.insert(out.end(), headerBytes, headerBytes + sizeof(packetHeader));
+	out.insert(out.end(), builder.GetBufferPointer(), builder.GetBufferPointer() + builder.GetSize());
+}
+
+static std::vector<uint8_t> convertChunk(const Chunk &chunk) {
+	std::vector<uint8_t> out;
+	flatbuffers::FlatBufferBuilder builder(1024 * 1024);
+
+	bool waitForSync = chunk.waitForSync;
+
+	// Same order as the module: triggers first, then events, frames and IMU.
+	for (const auto &container : chunk.containers) {
+		if (auto special = container.packets[SPECIAL_EVENT]) {
+			dv::TriggerPacket triggers;
+			Aedat4Convert::convert<SPECIAL_EVENT>(special, triggers);
+
+			if (!triggers.elements.empty()) {
+				serializePacket(out, builder, TRIGGERS, triggers);
+			}
+
+			if (waitForSync) {
+				waitForSync = !hasTimestampReset(special);
+			}
+		}
+
+		if (waitForSync) {
+			// Triggers always go out, all other data only after the sync.
+			continue;
+		}
+
+		if (auto polarity = container.packets[POLARITY_EVENT]) {
+			dv::EventPacket events;
+			Aedat4Convert::convert<POLARITY_EVENT>(polarity, events);
+
+			if (!events.elements.empty()) {
+				serializePacket(out, builder, EVENTS, events);
+			}
+		}
+
+		if (auto frame = container.packets[FRAME_EVENT]) {
+			for (int32_t i = 0; i < caerEventPacketHeaderGetEventNumber(frame); i++) {
+				dv::Frame newFrame;
+
+				if (Aedat4Convert::convert<FRAME_EVENT>(frame, i, newFrame)) {
+					serializePacket(out, builder, FRAMES, newFrame);
+				}
+			}
+		}
+
+		if (auto imu = container.packets[IMU6_EVENT]) {
+			dv::IMUPacket samples;
+			Aedat4Convert::convert<IMU6_EVENT>(imu, samples);
+
+			if (!samples.elements.empty()) {
+				serializePacket(out, builder, IMU, samples);
+			}
+		}
+	}
+
+	return (out);
+}
+
+int main(int argc, char *argv[]) {
+	size_t threadsNumber   = std::thread::hardware_concurrency();
+	size_t chunkContainers = 64;
+	bool waitForSync       = false;
+	const char *inputPath  = nullptr;
+	const char *outputPath = nullptr;
+
+	for (int i = 1; i < argc; i++) {
+		std::string arg{argv[i]};
+
+		if ((arg == "-j") && ((i + 1) < argc)) {
+			threadsNumber = std::strtoul(argv[++i], nullptr, 10);
+		}
+		else if ((arg == "-c") && ((i + 1) < argc)) {
+			chunkContainers = std::max<size_t>(std::strtoul(argv[++i], nullptr, 10), 1);
+		}
+		else if (arg == "-s") {
+			waitForSync = true;
+		}
+		else if (inputPath == nullptr) {
+			inputPath = argv[i];
+		}
+		else if (outputPath == nullptr) {
+			outputPath = argv[i];
+		}
+		else {
+			usage(argv[0]);
+			return (EXIT_FAILURE);
+		}
+	}
+
+	if ((inputPath == nullptr) || (outputPath == nullptr)) {
+		usage(argv[0]);
+		return (EXIT_FAILURE);
+	}
+
+	try {
+		RawCapture::MappedFile input(inputPath);
+		RawCapture::Reader reader(input);
+
+		std::ofstream output(outputPath, std::ios::binary | std::ios::trunc);
+		if (!output) {
+			std::cerr << "Failed to open output file '" << outputPath << "'." << std::endl;
+			return (EXIT_FAILURE);
+		}
+
+		writeHeader(output, reader.header(), estimateTimestampOffset(reader, waitForSync));
+
+		ThreadPool pool(threadsNumber);
+
+		// Bounded pipeline: converted chunks are written strictly in order.
+		struct Pending {
+			std::future<std::vector<uint8_t>> result;
+			size_t inputEnd;
+		};
+
+		std::deque<Pending> pending;
+		const size_t maxPending = 2 * pool.size();
+
+		auto writeOldest = [&]() {
+			auto data = pending.front().result.get();
+			output.write(reinterpret_cast<const char *>(data.data()), static_cast<std::streamsize>(data.size()));
+
+			// Everything up to here is converted and written, drop it from memory.
+			input.release(pending.front().inputEnd);
+			pending.pop_front();
+		};
+
+		size_t containersNumber = 0;
+		bool moreData           = true;
+
+		while (moreData) {
+			Chunk chunk;
+			chunk.waitForSync = waitForSync;
+			chunk.containers.reserve(chunkContainers);
+
+			RawCapture::ContainerView view;
+
+			while (chunk.containers.size() < chunkContainers) {
+				if (!reader.next(view)) {
+					moreData = false;
+					break;
+				}
+
+				if (waitForSync) {
+					waitForSync = !hasTimestampReset(view.packets[SPECIAL_EVENT]);
+				}
+
+				chunk.containers.push_back(view);
+			}
+
+			if (chunk.containers.empty()) {
+				break;
+			}
+
+			containersNumber += chunk.containers.size();
+
+			auto result = pool.submit([chunk = std::move(chunk)]() {
+				return (convertChunk(chunk));
+			});
+
+			pending.push_back({std::move(result), reader.position()});
+
+			if (pending.size() >= maxPending) {
+				writeOldest();
+			}
+		}
+
+		while (!pending.empty()) {
+			writeOldest();
+		}
+
+		output.close();
+
+		if (!output) {
+			std::cerr << "Failed to write output file '" << outputPath << "'." << std::endl;
+			return (EXIT_FAILURE);
+		}
+
+		std::cout << "Converted " << containersNumber << " containers." << std::endl;
+	}
+	catch (const std::exception &ex) {
+		std::cerr << ex.what() << std::endl;
+		return (EXIT_FAILURE);
+	}
+
+	return (EXIT_SUCCESS);
+}
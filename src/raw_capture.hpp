@@ -0,0 +1,310 @@
+#ifndef RAW_CAPTURE_HPP
+#define RAW_CAPTURE_HPP
+
+#include <libcaer/devices/davis.h>
+#include <libcaer/events/common.h>
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+
+#if defined(_WIN32)
+#	include <fstream>
+#	include <vector>
+#else
+#	include <fcntl.h>
+#	include <sys/mman.h>
+#	include <sys/stat.h>
+#	include <unistd.h>
+#endif
+
+/**
+ * Raw libcaer capture files: exactly what came out of the device, before any
+ * conversion, so it can be replayed through the same code paths later.
+ *
+ * Layout (native endianness):
+ *  - FileHeader (64 bytes): magic (0), version (8), chipID (12), dvsSizeX (14),
+ *    dvsSizeY (16), apsSizeX (18), apsSizeY (20), apsColorFilter (22),
+ *    serialNumber (24, 9 bytes), zero-filled reserved bytes (33 to 63).
+ *  - Container records until the end of the file or the first record without
+ *    CONTAINER_MAGIC (preallocated files have a zero-filled tail):
+ *     - ContainerHeader (24 bytes).
+ *     - 'packetsNumber' libcaer packets, each the caer_event_packet_header
+ *       followed by eventCapacity * eventSize bytes of event memory. Written
+ *       with eventCapacity = eventNumber, the unused tail of libcaer's
+ *       buffers is not stored.
+ */
+namespace RawCapture {
+
+static constexpr char FILE_MAGIC[8]        = {'N', 'V', 'P', 'R', 'A', 'W', '0', '1'};
+static constexpr uint32_t FILE_VERSION     = 1;
+static constexpr uint32_t CONTAINER_MAGIC  = 0x544E4F43; // "CONT"
+static constexpr size_t MAX_PACKET_TYPES   = 4;          // SPECIAL, POLARITY, FRAME, IMU6.
+static constexpr size_t PACKET_HEADER_SIZE = sizeof(struct caer_event_packet_header);
+
+struct FileHeader {
+	char magic[8];
+	uint32_t version;
+	int16_t chipID;
+	int16_t dvsSizeX;
+	int16_t dvsSizeY;
+	int16_t apsSizeX;
+	int16_t apsSizeY;
+	int16_t apsColorFilter;
+	char serialNumber[9];
+	uint8_t reserved[31]; // Zero, pads the header to 64 bytes.
+};
+
+static_assert(sizeof(FileHeader) == 64, "RawCapture::FileHeader must be 64 bytes");
+static_assert((offsetof(FileHeader, version) == 8) && (offsetof(FileHeader, chipID) == 12)
+				  && (offsetof(FileHeader, dvsSizeX) == 14) && (offsetof(FileHeader, dvsSizeY) == 16)
+				  && (offsetof(FileHeader, apsSizeX) == 18) && (offsetof(FileHeader, apsSizeY) == 20)
+				  && (offsetof(FileHeader, apsColorFilter) == 22) && (offsetof(FileHeader, serialNumber) == 24)
+				  && (offsetof(FileHeader, reserved) == 33),
+	"RawCapture::FileHeader fields must be at their file format offsets");
+
+struct ContainerHeader {
+	uint32_t magic;
+	uint32_t packetsNumber;
+	int64_t hostTime; // Unix time in µs when the container was received.
+	uint64_t size;    // Bytes of packet data following this header.
+};
+
+static_assert(sizeof(ContainerHeader) == 24, "RawCapture::ContainerHeader must be 24 bytes");
+static_assert((offsetof(ContainerHeader, packetsNumber) == 4) && (offsetof(ContainerHeader, hostTime) == 8)
+				  && (offsetof(ContainerHeader, size) == 16),
+	"RawCapture::ContainerHeader fields must be at their file format offsets");
+
+// Bytes a packet takes in a capture: header and used events only.
+static inline size_t packetSize(caerEventPacketHeaderConst packet) {
+	return (PACKET_HEADER_SIZE
+			+ (static_cast<size_t>(caerEventPacketHeaderGetEventSize(packet))
+				* static_cast<size_t>(caerEventPacketHeaderGetEventNumber(packet))));
+}
+
+// Bytes a packet read from a capture spans, by its stored capacity (also right for
+// older captures, which stored the whole buffer).
+static inline size_t storedPacketSize(caerEventPacketHeaderConst packet) {
+	return (PACKET_HEADER_SIZE
+			+ (static_cast<size_t>(caerEventPacketHeaderGetEventSize(packet))
+				* static_cast<size_t>(caerEventPacketHeaderGetEventCapacity(packet))));
+}
+
+static inline FileHeader makeFileHeader(const struct caer_davis_info &info) {
+	FileHeader header{};
+
+	memcpy(header.magic, FILE_MAGIC, sizeof(FILE_MAGIC));
+	header.version        = FILE_VERSION;
+	header.chipID         = info.chipID;
+	header.dvsSizeX       = info.dvsSizeX;
+	header.dvsSizeY       = info.dvsSizeY;
+	header.apsSizeX       = info.apsSizeX;
+	header.apsSizeY       = info.apsSizeY;
+	header.apsColorFilter = static_cast<int16_t>(info.apsColorFilter);
+	strncpy(header.serialNumber, info.deviceSerialNumber, sizeof(header.serialNumber) - 1);
+
+	return (header);
+}
+
+static inline struct caer_davis_info makeDeviceInfo(const FileHeader &header) {
+	struct caer_davis_info info = {};
+
+	info.chipID         = header.chipID;
+	info.dvsSizeX       = header.dvsSizeX;
+	info.dvsSizeY       = header.dvsSizeY;
+	info.apsSizeX       = header.apsSizeX;
+	info.apsSizeY       = header.apsSizeY;
+	info.apsColorFilter = static_cast<enum caer_frame_event_color_filter>(header.apsColorFilter);
+	memcpy(info.deviceSerialNumber, header.serialNumber, sizeof(info.deviceSerialNumber) - 1);
+
+	return (info);
+}
+
+/**
+ * One container record, pointing into the mapped file. Packets are indexed by
+ * their event type, absent types are nullptr.
+ */
+struct ContainerView {
+	int64_t hostTime;
+	std::array<caerEventPacketHeader, MAX_PACKET_TYPES> packets;
+};
+
+/**
+ * Read-only (copy-on-write) memory mapping of a whole file.
+ */
+class MappedFile {
+public:
+	explicit MappedFile(const std::string &path) {
+#if defined(_WIN32)
+		std::ifstream file(path, std::ios::binary | std::ios::ate);
+		if (!file) {
+			throw std::runtime_error("Failed to open raw capture file '" + path + "'.");
+		}
+
+		buffer.resize(static_cast<size_t>(file.tellg()));
+		file.seekg(0);
+		file.read(reinterpret_cast<char *>(buffer.data()), static_cast<std::streamsize>(buffer.size()));
+
+		mapping = buffer.data();
+		length  = buffer.size();
+#else
+		int fd = open(path.c_str(), O_RDONLY);
+		if (fd < 0) {
+			throw std::runtime_error("Failed to open raw capture file '" + path + "'.");
+		}
+
+		struct stat fileStat;
+		if ((fstat(fd, &fileStat) != 0) || (fileStat.st_size <= 0)) {
+			close(fd);
+			throw std::runtime_error("Failed to stat raw capture file '" + path + "'.");
+		}
+
+		length = static_cast<size_t>(fileStat.st_size);
+
+		// Private mapping: packets can be modified in place without touching the file.
+		void *addr = mmap(nullptr, length, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+		close(fd);
+
+		if (addr == MAP_FAILED) {
+			throw std::runtime_error("Failed to map raw capture file '" + path + "'.");
+		}
+
+		madvise(addr, length, MADV_SEQUENTIAL);
+
+		mapping = static_cast<uint8_t *>(addr);
+#endif
+	}
+
+	~MappedFile() {
+#if !defined(_WIN32)
+		munmap(mapping, length);
+#endif
+	}
+
+	MappedFile(const MappedFile &) = delete;
+	MappedFile &operator=(const MappedFile &) = delete;
+
+	uint8_t *data() const {
+		return (mapping);
+	}
+
+	size_t size() const {
+		return (length);
+	}
+
+	/**
+	 * Hint that everything before 'offset' will not be needed again.
+	 */
+	void release(size_t offset) const {
+#if !defined(_WIN32)
+		auto pageSize = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+		offset        = (offset / pageSize) * pageSize;
+
+		if (offset > 0) {
+			madvise(mapping, offset, MADV_DONTNEED);
+		}
+#else
+		(void) offset;
+#endif
+	}
+
+private:
+	uint8_t *mapping{nullptr};
+	size_t length{0};
+#if defined(_WIN32)
+	std::vector<uint8_t> buffer;
+#endif
+};
+
+/**
+ * Sequential reader over a mapped raw capture.
+ */
+class Reader {
+public:
+	explicit Reader(const MappedFile &mappedFile) : file(mappedFile) {
+		if (file.size() < sizeof(FileHeader)) {
+			throw std::runtime_error("Raw capture file too short.");
+		}
+
+		memcpy(&fileHeader, file.data(), sizeof(FileHeader));
+
+		if ((memcmp(fileHeader.magic, FILE_MAGIC, sizeof(FILE_MAGIC)) != 0) || (fileHeader.version != FILE_VERSION)) {
+			throw std::runtime_error("Not a raw capture file, or unsupported version.");
+		}
+
+		rewind();
+	}
+
+	const FileHeader &header() const {
+		return (fileHeader);
+	}
+
+	size_t position() const {
+		return (offset);
+	}
+
+	void rewind() {
+		offset = sizeof(FileHeader);
+	}
+
+	/**
+	 * Get the next container. Returns false at the end of the data.
+	 * Malformed records also end the data, so truncated captures stay usable.
+	 */
+	bool next(ContainerView &view) {
+		if ((file.size() - offset) < sizeof(ContainerHeader)) {
+			return (false);
+		}
+
+		ContainerHeader containerHeader;
+		memcpy(&containerHeader, file.data() + offset, sizeof(ContainerHeader));
+
+		if ((containerHeader.magic != CONTAINER_MAGIC)
+			|| (containerHeader.size > (file.size() - offset - sizeof(ContainerHeader)))) {
+			return (false);
+		}
+
+		view.hostTime = containerHeader.hostTime;
+		view.packets.fill(nullptr);
+
+		auto packetOffset = offset + sizeof(ContainerHeader);
+		auto packetsEnd   = packetOffset + containerHeader.size;
+
+		for (uint32_t i = 0; i < containerHeader.packetsNumber; i++) {
+			if ((packetsEnd - packetOffset) < PACKET_HEADER_SIZE) {
+				return (false);
+			}
+
+			auto packet = reinterpret_cast<caerEventPacketHeader>(file.data() + packetOffset);
+			auto size   = storedPacketSize(packet);
+
+			if (size > (packetsEnd - packetOffset)) {
+				return (false);
+			}
+
+			auto type = caerEventPacketHeaderGetEventType(packet);
+
+			if ((type >= 0) && (static_cast<size_t>(type) < MAX_PACKET_TYPES)) {
+				view.packets[static_cast<size_t>(type)] = packet;
+			}
+
+			packetOffset += size;
+		}
+
+		offset = packetsEnd;
+
+		return (true);
+	}
+
+private:
+	const MappedFile &file;
+	FileHeader fileHeader;
+	size_t offset;
+};
+
+} // namespace RawCapture
+
+#endif // RAW_CAPTURE_HPP
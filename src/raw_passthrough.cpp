@@ -0,0 +1,44 @@
+#include "raw_passthrough.hpp"
+
+#include <libcaercpp/events/utils.hpp>
+
+#include <map>
+#include <new>
+
+void *passthroughChannel(const std::string &key, void *(*create)()) {
+	// One registry per process: this is the only definition, in its own shared library.
+	static std::mutex registryLock;
+	static std::map<std::string, void *> registry;
+
+	std::scoped_lock lock(registryLock);
+
+	auto &entry = registry[key];
+	if (entry == nullptr) {
+		entry = create();
+	}
+
+	return (entry);
+}
+
+RawPassthrough::Container ownedContainerCopy(const libcaer::events::EventPacketContainer &container) {
+	auto copy = std::make_shared<libcaer::events::EventPacketContainer>();
+
+	// Same layout, index == type, empty slots stay empty.
+	for (int32_t i = 0; i < static_cast<int32_t>(container.size()); i++) {
+		auto packet = container.getEventPacket(i);
+
+		if (!packet) {
+			copy->addEventPacket(nullptr);
+			continue;
+		}
+
+		auto packetCopy = caerEventPacketCopy(packet->getHeaderPointer());
+		if (packetCopy == nullptr) {
+			throw std::bad_alloc();
+		}
+
+		copy->addEventPacket(libcaer::events::utils::makeSharedFromCStruct(packetCopy, true));
+	}
+
+	return (copy);
+}
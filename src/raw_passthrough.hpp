@@ -0,0 +1,150 @@
+#ifndef RAW_PASSTHROUGH_HPP
+#define RAW_PASSTHROUGH_HPP
+
+#include <libcaercpp/events/packetContainer.hpp>
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <typeinfo>
+#include <vector>
+
+#if defined(__GNUC__)
+#	define RAW_PASSTHROUGH_EXPORT __attribute__((visibility("default")))
+#else
+#	define RAW_PASSTHROUGH_EXPORT
+#endif
+
+/**
+ * Registry shared by everything linking nvp_raw_passthrough: the channel stored
+ * under 'key', made by 'create' on first use. Channels live as long as the
+ * process. Use Passthrough<Payload>::channel() instead.
+ */
+RAW_PASSTHROUGH_EXPORT void *passthroughChannel(const std::string &key, void *(*create)());
+
+/**
+ * Named in-process channels forwarding data the AEDAT4 outputs can't carry,
+ * e.g. libcaer containers exactly as they came from the device (RawPassthrough)
+ * for consumers that prefer the native layout.
+ *
+ * Only references are passed: subscribers receive the reference-counted
+ * payload and may keep it as long as they like, but must not modify it, the
+ * producer may still be reading it. Producers only publish payloads that own
+ * their memory (see ownedContainerCopy()). Callbacks run on the producer's
+ * thread and should hand the payload off rather than process it.
+ *
+ * Module outputs can only carry the registered AEDAT4 types, so this is a
+ * side channel between modules of the same runtime process, found by payload
+ * type and name. The channel registry lives in the nvp_raw_passthrough shared
+ * library, which producers and consumers both link, so they see the same
+ * channels however the runtime loads the modules.
+ */
+template<typename Payload>
+class Passthrough {
+public:
+	using Container = std::shared_ptr<const Payload>;
+	using Callback  = std::function<void(const Container &)>;
+
+	/**
+	 * Channel 'name' for this payload type, created on first use.
+	 */
+	static Passthrough &channel(const std::string &name) {
+		// Mangled type names are the same in all modules built with the same compiler.
+		auto key = std::string(typeid(Payload).name()) + "/" + name;
+
+		return (*static_cast<Passthrough *>(passthroughChannel(key, [] {
+			return (static_cast<void *>(new Passthrough()));
+		})));
+	}
+
+	/**
+	 * Returns an id for unsubscribe().
+	 */
+	int64_t subscribe(Callback callback) {
+		std::scoped_lock lock(subscribersLock);
+
+		auto updated = std::make_shared<std::vector<Subscriber>>(*subscribers);
+		updated->push_back({nextId, std::move(callback)});
+
+		subscribers = std::move(updated);
+		subscribersNumber.store(subscribers->size(), std::memory_order_release);
+
+		return (nextId++);
+	}
+
+	void unsubscribe(int64_t id) {
+		std::scoped_lock lock(subscribersLock);
+
+		auto updated = std::make_shared<std::vector<Subscriber>>();
+
+		for (const auto &subscriber : *subscribers) {
+			if (subscriber.id != id) {
+				updated->push_back(subscriber);
+			}
+		}
+
+		subscribers = std::move(updated);
+		subscribersNumber.store(subscribers->size(), std::memory_order_release);
+	}
+
+	bool hasSubscribers() const {
+		return (subscribersNumber.load(std::memory_order_acquire) > 0);
+	}
+
+	/**
+	 * Producer side. Returns the number of subscribers reached.
+	 */
+	size_t publish(const Container &container) {
+		if (!hasSubscribers()) {
+			return (0);
+		}
+
+		// Callbacks run outside the lock, on the list as it was when publishing started.
+		std::shared_ptr<const std::vector<Subscriber>> current;
+
+		{
+			std::scoped_lock lock(subscribersLock);
+			current = subscribers;
+		}
+
+		for (const auto &subscriber : *current) {
+			subscriber.callback(container);
+		}
+
+		published.fetch_add(1, std::memory_order_relaxed);
+
+		return (current->size());
+	}
+
+	int64_t publishedContainers() const {
+		return (published.load(std::memory_order_relaxed));
+	}
+
+private:
+	struct Subscriber {
+		int64_t id;
+		Callback callback;
+	};
+
+	std::mutex subscribersLock;
+	std::shared_ptr<const std::vector<Subscriber>> subscribers{std::make_shared<std::vector<Subscriber>>()};
+	std::atomic<size_t> subscribersNumber{0};
+	int64_t nextId{0};
+	std::atomic<int64_t> published{0};
+
+	Passthrough() = default;
+};
+
+using RawPassthrough = Passthrough<libcaer::events::EventPacketContainer>;
+
+/**
+ * Deep copy of a container whose packets don't own their memory (e.g. views
+ * into a memory-mapped capture), safe to keep after the source goes away.
+ */
+RAW_PASSTHROUGH_EXPORT RawPassthrough::Container ownedContainerCopy(
+	const libcaer::events::EventPacketContainer &container);
+
+#endif // RAW_PASSTHROUGH_HPP
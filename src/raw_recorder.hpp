@@ -0,0 +1,257 @@
+#ifndef RAW_RECORDER_HPP
+#define RAW_RECORDER_HPP
+
+#include "raw_capture.hpp"
+#include "spsc_queue.hpp"
+
+#include <libcaercpp/events/packetContainer.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <string>
+#include <thread>
+
+#if !defined(_WIN32)
+#	include <fcntl.h>
+#	include <sys/mman.h>
+#	include <unistd.h>
+#endif
+
+/**
+ * Records raw libcaer containers, exactly as they came from the device, into
+ * preallocated memory-mapped files in RawCapture format.
+ *
+ * The acquisition side only moves a reference to the container into a lock-free
+ * queue; when the queue is full the container is not recorded and counted as
+ * dropped, acquisition never waits. A writer thread copies packet headers and
+ * event memory straight from libcaer's buffers into the mapping. Files are
+ * fallocate'd to their full size up front, and rotate through 'filesNumber'
+ * names (<base>-<n>.raw), overwriting the oldest. Unused tails are truncated
+ * when a file is closed.
+ */
+class RawRecorder {
+public:
+	RawRecorder(const std::string &path, size_t size, size_t number, const RawCapture::FileHeader &header,
+		size_t queueSize) :
+		basePath(path),
+		fileSize(size),
+		filesNumber((number > 0) ? (number) : (1)),
+		fileHeader(header),
+		queue(queueSize) {
+		thread = std::thread(&RawRecorder::threadRun, this);
+	}
+
+	~RawRecorder() {
+		stopRequested.store(true, std::memory_order_release);
+		thread.join();
+	}
+
+	RawRecorder(const RawRecorder &) = delete;
+	RawRecorder &operator=(const RawRecorder &) = delete;
+
+	/**
+	 * Queue a container for recording. Never blocks, never copies event data.
+	 * Single producer: calls from several threads must be serialized.
+	 */
+	void record(std::shared_ptr<libcaer::events::EventPacketContainer> container, int64_t hostTime) {
+		Entry entry{std::move(container), hostTime};
+
+		if (!queue.push(std::move(entry))) {
+			droppedContainers.fetch_add(1, std::memory_order_relaxed);
+		}
+	}
+
+	int64_t dropped() const {
+		return (droppedContainers.load(std::memory_order_relaxed));
+	}
+
+	int64_t written() const {
+		return (bytesWritten.load(std::memory_order_relaxed));
+	}
+
+	bool failed() const {
+		return (writeFailed.load(std::memory_order_relaxed));
+	}
+
+private:
+	struct Entry {
+		std::shared_ptr<libcaer::events::EventPacketContainer> container;
+		int64_t hostTime;
+	};
+
+	std::string basePath;
+	size_t fileSize;
+	size_t filesNumber;
+	RawCapture::FileHeader fileHeader;
+
+	SPSCQueue<Entry> queue;
+	std::thread thread;
+	std::atomic_bool stopRequested{false};
+
+	std::atomic<int64_t> droppedContainers{0};
+	std::atomic<int64_t> bytesWritten{0};
+	std::atomic_bool writeFailed{false};
+
+	// Writer thread state.
+	int fd{-1};
+	uint8_t *mapping{nullptr};
+	size_t used{0};
+	size_t synced{0};
+	size_t fileIndex{0};
+
+	static constexpr size_t SYNC_CHUNK = 16 * 1024 * 1024;
+
+	std::string filePath(size_t index) const {
+		auto extension = basePath.rfind(".raw");
+
+		if ((extension != std::string::npos) && (extension == (basePath.length() - 4))) {
+			return (basePath.substr(0, extension) + "-" + std::to_string(index) + ".raw");
+		}
+
+		return (basePath + "-" + std::to_string(index) + ".raw");
+	}
+
+	void threadRun() {
+		Entry entry;
+
+		while (true) {
+			if (queue.pop(entry)) {
+				write(entry);
+				entry = Entry{};
+				continue;
+			}
+
+			// Only stop once everything queued is on disk.
+			if (stopRequested.load(std::memory_order_acquire)) {
+				break;
+			}
+
+			std::this_thread::sleep_for(std::chrono::milliseconds(1));
+		}
+
+		closeFile();
+	}
+
+	void write(const Entry &entry) {
+		if (writeFailed.load(std::memory_order_relaxed)) {
+			droppedContainers.fetch_add(1, std::memory_order_relaxed);
+			return;
+		}
+
+		RawCapture::ContainerHeader containerHeader{RawCapture::CONTAINER_MAGIC, 0, entry.hostTime, 0};
+
+		for (const auto &packet : *entry.container) {
+			if (packet) {
+				containerHeader.packetsNumber++;
+				containerHeader.size += RawCapture::packetSize(packet->getHeaderPointer());
+			}
+		}
+
+		auto recordSize = sizeof(RawCapture::ContainerHeader) + containerHeader.size;
+
+		if ((mapping == nullptr) || (recordSize > (fileSize - used))) {
+			if (!rotateFile(recordSize)) {
+				writeFailed.store(true, std::memory_order_relaxed);
+				droppedContainers.fetch_add(1, std::memory_order_relaxed);
+				return;
+			}
+		}
+
+		memcpy(mapping + used, &containerHeader, sizeof(RawCapture::ContainerHeader));
+		used += sizeof(RawCapture::ContainerHeader);
+
+		for (const auto &packet : *entry.container) {
+			if (packet) {
+				auto header = packet->getHeaderPointer();
+				auto size   = RawCapture::packetSize(header);
+
+				// Used events only, so the stored capacity is the event number.
+				memcpy(mapping + used, header, size);
+				caerEventPacketHeaderSetEventCapacity(reinterpret_cast<caerEventPacketHeader>(mapping + used),
+					caerEventPacketHeaderGetEventNumber(header));
+				used += size;
+			}
+		}
+
+		bytesWritten.fetch_add(static_cast<int64_t>(recordSize), std::memory_order_relaxed);
+
+#if !defined(_WIN32)
+		// Start write-back early, so dirty pages don't pile up.
+		if ((used - synced) >= SYNC_CHUNK) {
+			auto pageSize = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+			auto start    = (synced / pageSize) * pageSize;
+
+			msync(mapping + start, used - start, MS_ASYNC);
+			synced = used;
+		}
+#endif
+	}
+
+	bool rotateFile(size_t recordSize) {
+		closeFile();
+
+		if ((sizeof(RawCapture::FileHeader) + recordSize) > fileSize) {
+			// Container can never fit, file size too small.
+			return (false);
+		}
+
+#if defined(_WIN32)
+		// No mmap/fallocate, recording is not supported.
+		return (false);
+#else
+		auto path = filePath(fileIndex);
+		fileIndex = (fileIndex + 1) % filesNumber;
+
+		fd = open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+		if (fd < 0) {
+			return (false);
+		}
+
+		if (posix_fallocate(fd, 0, static_cast<off_t>(fileSize)) != 0) {
+			close(fd);
+			fd = -1;
+			return (false);
+		}
+
+		void *addr = mmap(nullptr, fileSize, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+		if (addr == MAP_FAILED) {
+			close(fd);
+			fd = -1;
+			return (false);
+		}
+
+		mapping = static_cast<uint8_t *>(addr);
+
+		memcpy(mapping, &fileHeader, sizeof(RawCapture::FileHeader));
+		used   = sizeof(RawCapture::FileHeader);
+		synced = 0;
+
+		return (true);
+#endif
+	}
+
+	void closeFile() {
+#if !defined(_WIN32)
+		if (mapping != nullptr) {
+			msync(mapping, used, MS_SYNC);
+			munmap(mapping, fileSize);
+			mapping = nullptr;
+		}
+
+		if (fd >= 0) {
+			// Drop the unused preallocated tail.
+			if (ftruncate(fd, static_cast<off_t>(used)) != 0) {
+				// Readers stop at the zero-filled tail anyway.
+			}
+
+			close(fd);
+			fd = -1;
+		}
+#endif
+
+		used = 0;
+	}
+};
+
+#endif // RAW_RECORDER_HPP
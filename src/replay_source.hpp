@@ -0,0 +1,174 @@
+#ifndef REPLAY_SOURCE_HPP
+#define REPLAY_SOURCE_HPP
+
+#include "raw_capture.hpp"
+
+#include <libcaercpp/events/frame.hpp>
+#include <libcaercpp/events/imu6.hpp>
+#include <libcaercpp/events/packetContainer.hpp>
+#include <libcaercpp/events/polarity.hpp>
+#include <libcaercpp/events/special.hpp>
+
+#include <chrono>
+#include <memory>
+#include <string>
+#include <thread>
+
+/**
+ * Stand-in for a live DAVIS: serves the containers of a raw capture file, with
+ * the same packet layout as libcaer (container index == event type), so they go
+ * through the same sync detection and conversion as live data.
+ *
+ * Packets reference the mapped file directly, nothing is copied. Containers are
+ * either paced by their recorded host arrival times or served as fast as
+ * possible. Optionally a single TIMESTAMP_RESET special event is injected before
+ * the first container (and on every loop), to exercise the sync gating.
+ */
+class ReplaySource {
+public:
+	ReplaySource(const std::string &path, bool pacedReplay, bool loopReplay, bool injectReset) :
+		file(path),
+		reader(file),
+		info(RawCapture::makeDeviceInfo(reader.header())),
+		recordedPace(pacedReplay),
+		loop(loopReplay),
+		injectTimestampReset(injectReset),
+		injectPending(injectReset) {
+	}
+
+	const struct caer_davis_info &infoGet() const {
+		return (info);
+	}
+
+	bool finished() const {
+		return (done);
+	}
+
+	/**
+	 * Get the next container, or nullptr if none is due yet or the capture ended.
+	 * Waits at most a few milliseconds, to keep the mainloop responsive.
+	 */
+	std::shared_ptr<libcaer::events::EventPacketContainer> dataGet() {
+		if (done) {
+			return (nullptr);
+		}
+
+		if (injectPending) {
+			injectPending = false;
+			return (makeTimestampReset());
+		}
+
+		if (!havePending) {
+			// Earlier containers were fully processed, let the kernel drop them.
+			file.release(reader.position());
+
+			if (!reader.next(pending)) {
+				if (!loop) {
+					done = true;
+					return (nullptr);
+				}
+
+				reader.rewind();
+				paceStarted   = false;
+				injectPending = injectTimestampReset;
+
+				if (!reader.next(pending)) {
+					// Empty capture.
+					done = true;
+					return (nullptr);
+				}
+			}
+
+			havePending = true;
+		}
+
+		if (recordedPace && !waitUntilDue(pending.hostTime)) {
+			return (nullptr);
+		}
+
+		havePending = false;
+
+		return (makeContainer(pending));
+	}
+
+private:
+	RawCapture::MappedFile file;
+	RawCapture::Reader reader;
+	struct caer_davis_info info;
+
+	bool recordedPace;
+	bool loop;
+	bool injectTimestampReset;
+	bool injectPending;
+	bool done{false};
+
+	RawCapture::ContainerView pending;
+	bool havePending{false};
+
+	bool paceStarted{false};
+	int64_t paceFirstHostTime{0};
+	std::chrono::steady_clock::time_point paceStart;
+
+	bool waitUntilDue(int64_t hostTime) {
+		if (!paceStarted) {
+			paceStarted       = true;
+			paceFirstHostTime = hostTime;
+			paceStart         = std::chrono::steady_clock::now();
+		}
+
+		auto due       = paceStart + std::chrono::microseconds(hostTime - paceFirstHostTime);
+		auto remaining = due - std::chrono::steady_clock::now();
+
+		if (remaining > std::chrono::milliseconds(5)) {
+			std::this_thread::sleep_for(std::chrono::milliseconds(5));
+			return (false);
+		}
+
+		if (remaining > std::chrono::steady_clock::duration::zero()) {
+			std::this_thread::sleep_for(remaining);
+		}
+
+		return (true);
+	}
+
+	static std::shared_ptr<libcaer::events::EventPacketContainer> makeContainer(
+		const RawCapture::ContainerView &view) {
+		auto container = std::make_shared<libcaer::events::EventPacketContainer>();
+
+		// Same layout as libcaer's DAVIS containers: index == event type.
+		container->addEventPacket((view.packets[SPECIAL_EVENT] != nullptr)
+									  ? (std::make_shared<libcaer::events::SpecialEventPacket>(
+										  view.packets[SPECIAL_EVENT], false))
+									  : (nullptr));
+		container->addEventPacket((view.packets[POLARITY_EVENT] != nullptr)
+									  ? (std::make_shared<libcaer::events::PolarityEventPacket>(
+										  view.packets[POLARITY_EVENT], false))
+									  : (nullptr));
+		container->addEventPacket((view.packets[FRAME_EVENT] != nullptr)
+									  ? (std::make_shared<libcaer::events::FrameEventPacket>(
+										  view.packets[FRAME_EVENT], false))
+									  : (nullptr));
+		container->addEventPacket((view.packets[IMU6_EVENT] != nullptr)
+									  ? (std::make_shared<libcaer::events::IMU6EventPacket>(
+										  view.packets[IMU6_EVENT], false))
+									  : (nullptr));
+
+		return (container);
+	}
+
+	static std::shared_ptr<libcaer::events::EventPacketContainer> makeTimestampReset() {
+		auto special = std::make_shared<libcaer::events::SpecialEventPacket>(1, 0, 0);
+
+		auto &reset = (*special)[0];
+		reset.setTimestamp(INT32_MAX);
+		reset.setType(TIMESTAMP_RESET);
+		reset.validate(*special);
+
+		auto container = std::make_shared<libcaer::events::EventPacketContainer>();
+		container->addEventPacket(special);
+
+		return (container);
+	}
+};
+
+#endif // REPLAY_SOURCE_HPP
@@ -0,0 +1,180 @@
+#ifndef SIMD_DISPATCH_HPP
+#define SIMD_DISPATCH_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+/**
+ * Run-time CPU dispatch for the vectorized kernels.
+ *
+ * A kernel is written once, as a plain loop the compiler can vectorize, and
+ * SIMD_KERNEL() compiles it four times: scalar (baseline flags), SSE4.2, AVX2
+ * and AVX-512. By default the best variant the CPU supports runs, detected
+ * once per process from CPUID. A module instance can force a lower one for A/B
+ * tests by holding a Scope on the threads running its kernels, so instances
+ * never override each other.
+ *
+ * Outside of x86 with GCC/Clang all variants are the scalar one.
+ */
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__)
+#	define SIMD_DISPATCH_X86 1
+#	define SIMD_TARGET(isa) __attribute__((target(isa)))
+#else
+#	define SIMD_DISPATCH_X86 0
+#	define SIMD_TARGET(isa)
+#endif
+
+#if defined(__GNUC__)
+#	define SIMD_ALWAYS_INLINE inline __attribute__((always_inline))
+#else
+#	define SIMD_ALWAYS_INLINE inline
+#endif
+
+namespace Simd {
+
+enum class Level : int {
+	SCALAR = 0,
+	SSE42  = 1,
+	AVX2   = 2,
+	AVX512 = 3,
+};
+
+inline constexpr const char *LEVEL_NAMES[] = {"Scalar", "SSE4.2", "AVX2", "AVX-512"};
+
+inline const char *name(Level level) {
+	return (LEVEL_NAMES[static_cast<int>(level)]);
+}
+
+/**
+ * Best level this CPU supports. CPUID is only queried once.
+ */
+inline Level detect() {
+	static const Level detected = [] {
+#if SIMD_DISPATCH_X86
+		__builtin_cpu_init();
+
+		if (__builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512bw")
+			&& __builtin_cpu_supports("avx512vl")) {
+			return (Level::AVX512);
+		}
+		if (__builtin_cpu_supports("avx2")) {
+			return (Level::AVX2);
+		}
+		if (__builtin_cpu_supports("sse4.2")) {
+			return (Level::SSE42);
+		}
+#endif
+		return (Level::SCALAR);
+	}();
+
+	return (detected);
+}
+
+// Detected at library load, used where no Scope is active.
+inline const int detectedLevel{static_cast<int>(detect())};
+
+// Level forced on this thread, -1 for the detected one.
+inline thread_local int threadLevel{-1};
+
+inline Level active() {
+	return (static_cast<Level>((threadLevel >= 0) ? (threadLevel) : (detectedLevel)));
+}
+
+/**
+ * Level for a variant name: "Auto" (or anything unknown) for the detected
+ * level, or one of LEVEL_NAMES. Levels the CPU doesn't support fall back to the
+ * detected one.
+ */
+inline Level resolve(const std::string &variant) {
+	auto level = detect();
+
+	for (int i = 0; i <= static_cast<int>(Level::AVX512); i++) {
+		if ((variant == LEVEL_NAMES[i]) && (i <= static_cast<int>(detect()))) {
+			level = static_cast<Level>(i);
+		}
+	}
+
+	return (level);
+}
+
+/**
+ * Run the kernels called on this thread at 'level' while in scope, then go
+ * back to the previous one. Work handed to other threads takes the level along
+ * (see active()).
+ */
+class Scope {
+public:
+	explicit Scope(Level level) : previous(threadLevel) {
+		threadLevel = static_cast<int>(level);
+	}
+
+	~Scope() {
+		threadLevel = previous;
+	}
+
+	Scope(const Scope &)            = delete;
+	Scope &operator=(const Scope &) = delete;
+
+private:
+	int previous;
+};
+
+/**
+ * The four compiled variants of a kernel, called through the active level.
+ */
+template<typename R, typename... Args>
+class Kernel {
+public:
+	using Function = R (*)(Args...);
+
+	constexpr Kernel(Function scalar, Function sse42, Function avx2, Function avx512) :
+		variants{scalar, sse42, avx2, avx512} {
+	}
+
+	R operator()(Args... args) const {
+		return (variants[(threadLevel >= 0) ? (threadLevel) : (detectedLevel)](args...));
+	}
+
+private:
+	Function variants[4];
+};
+
+} // namespace Simd
+
+/**
+ * Define kernel NAME from an always-inline NAME##Body with the same signature.
+ * PARAMS is the parenthesized parameter list, ARGS the argument names, and the
+ * rest the parameter types, e.g.:
+ *
+ *   SIMD_KERNEL(void, narrow, (const uint16_t *in, uint8_t *out, size_t n), (in, out, n),
+ *       const uint16_t *, uint8_t *, size_t);
+ */
+#if SIMD_DISPATCH_X86
+#	define SIMD_KERNEL(RET, NAME, PARAMS, ARGS, ...)                                     \
+		static inline RET NAME##Scalar PARAMS {                                           \
+			return (NAME##Body ARGS);                                                     \
+		}                                                                                 \
+		SIMD_TARGET("sse4.2") static inline RET NAME##SSE42 PARAMS {                      \
+			return (NAME##Body ARGS);                                                     \
+		}                                                                                 \
+		SIMD_TARGET("avx2") static inline RET NAME##AVX2 PARAMS {                         \
+			return (NAME##Body ARGS);                                                     \
+		}                                                                                 \
+		SIMD_TARGET("avx512f,avx512bw,avx512vl") static inline RET NAME##AVX512 PARAMS {  \
+			return (NAME##Body ARGS);                                                     \
+		}                                                                                 \
+		static const Simd::Kernel<RET, __VA_ARGS__> NAME {                                \
+			&NAME##Scalar, &NAME##SSE42, &NAME##AVX2, &NAME##AVX512                       \
+		}
+#else
+#	define SIMD_KERNEL(RET, NAME, PARAMS, ARGS, ...)                                     \
+		static inline RET NAME##Scalar PARAMS {                                           \
+			return (NAME##Body ARGS);                                                     \
+		}                                                                                 \
+		static const Simd::Kernel<RET, __VA_ARGS__> NAME {                                \
+			&NAME##Scalar, &NAME##Scalar, &NAME##Scalar, &NAME##Scalar                    \
+		}
+#endif
+
+#endif // SIMD_DISPATCH_HPP
@@ -1,11 +1,68 @@
 #define DV_API_OPENCV_SUPPORT 0
 #include "dv-sdk/module.hpp"
 
+#include "simd_dispatch.hpp"
+
 #include <vector>
 
 
 using matrixBufferT     = std::vector<uint32_t>;
 
+struct SionoiseParams {
+	uint32_t *matrix;
+	int sizeX;
+	int sizeY;
+	int sz;
+	uint32_t threshold;
+};
+
+// Any timestamp in a neighbourhood column less than 'threshold' before 't'. No
+// early exit, so the compiler can vectorize it.
+static SIMD_ALWAYS_INLINE bool anyRecent(const uint32_t *column, int count, uint32_t t, uint32_t threshold) {
+	uint32_t found = 0;
+
+	for (int j = 0; j < count; j++) {
+		found |= static_cast<uint32_t>((t - column[j]) < threshold);
+	}
+
+	return (found != 0);
+}
+
+// Filter a whole packet: keep[i] is set for events with a recent neighbour.
+static SIMD_ALWAYS_INLINE void filterEventsBody(
+	const dv::Event *events, size_t count, uint8_t *keep, const SionoiseParams &p) {
+	for (size_t n = 0; n < count; n++) {
+		auto x = events[n].x();
+		auto y = events[n].y();
+		auto t = static_cast<uint32_t>(events[n].timestamp());
+
+		bool pass = false;
+
+		// boundary
+		if (y >= p.sz && y < p.sizeY - p.sz && x >= p.sz && x < p.sizeX - p.sz) {
+			for (int i = -p.sz; i <= p.sz && !pass; i++) {
+				const uint32_t *column = &p.matrix[(x + i) * p.sizeY + y - p.sz];
+
+				if (i == 0) {
+					// Not the event's own pixel.
+					pass = anyRecent(column, p.sz, t, p.threshold)
+						   || anyRecent(column + p.sz + 1, p.sz, t, p.threshold);
+				}
+				else {
+					pass = anyRecent(column, 2 * p.sz + 1, t, p.threshold);
+				}
+			}
+		}
+
+		keep[n] = pass;
+
+		p.matrix[x * p.sizeY + y] = t;
+	}
+}
+
+SIMD_KERNEL(void, filterEvents, (const dv::Event *events, size_t count, uint8_t *keep, const SionoiseParams &p),
+	(events, count, keep, p), const dv::Event *, size_t, uint8_t *, const SionoiseParams &);
+
 class Sionoise : public dv::ModuleBase {
 public:
 	static const char *initDescription() {
@@ -23,6 +80,10 @@ public:
 	static void initConfigOptions(dv::RuntimeConfig &config) {
         config.add("threshold", dv::ConfigOption::intOption("Threshold value for timestamps.", 1, 1, 10000));  // ?
         config.add("size", dv::ConfigOption::intOption("Neighbourhood size (actually this*2+1).", 1, 1, 50));
+        config.add("simd/ForceVariant",
+            dv::ConfigOption::listOption("Force a SIMD code variant (A/B testing), Auto selects the best one the "
+                                         "CPU supports.",
+                0, {"Auto", "Scalar", "SSE4.2", "AVX2", "AVX-512"}));
         config.setPriorityOptions({"threshold", "size"});
     }
 
@@ -32,6 +93,9 @@ public:
         sizeY        = input.sizeY();
         matrixMem.resize(sizeX * sizeY);
         outputs.getEventOutput("events").setup(inputs.getEventInput("events"));
+
+        moduleNode.getRelativeNode("simd/").create<dv::CfgType::STRING>("Variant", Simd::name(Simd::active()),
+            {0, 32}, dv::CfgFlags::READ_ONLY | dv::CfgFlags::NO_EXPORT, "SIMD code variant in use.");
     }
 
 	void run() override {
@@ -42,14 +106,18 @@ public:
             return;
         }
 
-        for (auto &evt : inEvent) {
+        keep.resize(inEvent.size());
 
-            // apply filter
-            if (filterEvent(evt)) {
-                outEvent << evt;
-            }
+        // This instance's variant, other instances may force a different one.
+        Simd::Scope simdScope(simdLevel);
+
+        SionoiseParams params = {matrixMem.data(), sizeX, sizeY, sz, threshold};
+        filterEvents(&inEvent[0], inEvent.size(), keep.data(), params);
 
-            updateMatrix(evt);
+        for (size_t i = 0; i < inEvent.size(); i++) {
+            if (keep[i]) {
+                outEvent << inEvent[i];
+            }
         }
         outEvent << dv::commit;
     }
@@ -57,6 +125,16 @@ public:
 	void configUpdate() override {
         sz = config.getInt("size");
         threshold = static_cast<uint32_t>(config.getInt("threshold"));
+
+        auto variant = config.getString("simd/ForceVariant");
+        simdLevel    = Simd::resolve(variant);
+
+        if (variant != "Auto" && variant != Simd::name(simdLevel)) {
+            log.warning << "SIMD variant " << variant << " not supported by this CPU, using "
+                        << Simd::name(simdLevel) << "." << dv::logEnd;
+        }
+
+        moduleNode.getRelativeNode("simd/").updateReadOnly<dv::CfgType::STRING>("Variant", Simd::name(simdLevel));
     }
 
 private:
@@ -65,38 +143,8 @@ private:
 	int sizeX;
 	int sizeY;
 	int sz;
-
-	void updateMatrix(const dv::Event &event) {
-        auto address                 = event.x() * sizeY + event.y();
-        matrixMem[address] = static_cast<int32_t>(event.timestamp());
-    }
-
-	bool filterEvent(const dv::Event &event) {
-
-        auto x = event.x();
-	    auto y = event.y();
-        auto t = static_cast<uint32_t>(event.timestamp());
-
-        // boundary
-        if (y < sz || y >= sizeY - sz || x < sz || x >= sizeX - sz) {
-            return false;
-        }
-
-        for (int i = -sz; i <= sz; i++) {
-            for (int j = -sz; j <= sz; j++) {
-                if (i == 0 && j == 0) {
-                    continue;
-                }
-                auto address = (event.x() + i) * sizeY + event.y() + j;
-                if (t - matrixMem[address] < threshold) {
-                    return true;
-                }
-            }
-        }
-
-        return false;
-    }
-
+	std::vector<uint8_t> keep;
+	Simd::Level simdLevel{Simd::detect()};
 };
 
 registerModuleClass(Sionoise)
\ No newline at end of file
@@ -0,0 +1,79 @@
+#ifndef SPSC_QUEUE_HPP
+#define SPSC_QUEUE_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+/**
+ * Bounded lock-free single-producer single-consumer queue.
+ * Storage is allocated once at construction, push/pop never allocate.
+ */
+template<typename T>
+class SPSCQueue {
+public:
+	explicit SPSCQueue(size_t capacity) : slots(roundUpPowerOfTwo(capacity + 1)), mask(slots.size() - 1) {
+	}
+
+	SPSCQueue(const SPSCQueue &) = delete;
+	SPSCQueue &operator=(const SPSCQueue &) = delete;
+
+	/**
+	 * Producer side. Returns false (and leaves 'value' untouched) if full.
+	 */
+	bool push(T &&value) {
+		auto head = writeIndex.load(std::memory_order_relaxed);
+		auto next = (head + 1) & mask;
+
+		if (next == readIndex.load(std::memory_order_acquire)) {
+			return (false);
+		}
+
+		slots[head] = std::move(value);
+		writeIndex.store(next, std::memory_order_release);
+
+		return (true);
+	}
+
+	/**
+	 * Consumer side. Returns false if empty.
+	 */
+	bool pop(T &value) {
+		auto tail = readIndex.load(std::memory_order_relaxed);
+
+		if (tail == writeIndex.load(std::memory_order_acquire)) {
+			return (false);
+		}
+
+		value       = std::move(slots[tail]);
+		slots[tail] = T{};
+		readIndex.store((tail + 1) & mask, std::memory_order_release);
+
+		return (true);
+	}
+
+	bool empty() const {
+		return (readIndex.load(std::memory_order_acquire) == writeIndex.load(std::memory_order_acquire));
+	}
+
+private:
+	std::vector<T> slots;
+	size_t mask;
+
+	// Keep producer and consumer indexes on separate cache lines.
+	alignas(64) std::atomic<size_t> writeIndex{0};
+	alignas(64) std::atomic<size_t> readIndex{0};
+
+	static size_t roundUpPowerOfTwo(size_t value) {
+		size_t result = 2;
+
+		while (result < value) {
+			result <<= 1;
+		}
+
+		return (result);
+	}
+};
+
+#endif // SPSC_QUEUE_HPP
@@ -0,0 +1,148 @@
+#ifndef THREAD_AFFINITY_HPP
+#define THREAD_AFFINITY_HPP
+
+#include <cerrno>
+#include <cstring>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#if defined(__linux__)
+#	include <pthread.h>
+#	include <sched.h>
+#endif
+
+/**
+ * CPU pinning and real-time priority for the calling thread.
+ */
+namespace ThreadAffinity {
+
+/**
+ * Parse a core list like "2", "2,3" or "0-3,6". Invalid parts are skipped.
+ */
+static inline std::vector<int> parseCores(const std::string &list) {
+	std::vector<int> cores;
+	std::stringstream stream(list);
+	std::string part;
+
+	while (std::getline(stream, part, ',')) {
+		auto dash = part.find('-');
+
+		try {
+			if (dash == std::string::npos) {
+				cores.push_back(std::stoi(part));
+			}
+			else {
+				auto first = std::stoi(part.substr(0, dash));
+				auto last  = std::stoi(part.substr(dash + 1));
+
+				for (int core = first; core <= last; core++) {
+					cores.push_back(core);
+				}
+			}
+		}
+		catch (const std::exception &) {
+			// Skip empty or malformed entries.
+		}
+	}
+
+	return (cores);
+}
+
+/**
+ * Current affinity and scheduling policy of the calling thread, as text.
+ */
+static inline std::string describe() {
+#if defined(__linux__)
+	std::string result = "cores ";
+
+	cpu_set_t set;
+	CPU_ZERO(&set);
+
+	if (pthread_getaffinity_np(pthread_self(), sizeof(set), &set) == 0) {
+		bool first = true;
+
+		for (int core = 0; core < CPU_SETSIZE; core++) {
+			if (CPU_ISSET(core, &set)) {
+				result += (first) ? ("") : (",");
+				result += std::to_string(core);
+				first = false;
+			}
+		}
+	}
+	else {
+		result += "unknown";
+	}
+
+	int policy;
+	struct sched_param param;
+
+	if (pthread_getschedparam(pthread_self(), &policy, &param) == 0) {
+		if (policy == SCHED_FIFO) {
+			result += ", SCHED_FIFO " + std::to_string(param.sched_priority);
+		}
+		else if (policy == SCHED_RR) {
+			result += ", SCHED_RR " + std::to_string(param.sched_priority);
+		}
+		else {
+			result += ", SCHED_OTHER";
+		}
+	}
+
+	return (result);
+#else
+	return ("unsupported on this platform");
+#endif
+}
+
+/**
+ * Pin the calling thread to 'cores' (empty = leave the affinity, e.g. from
+ * taskset, alone) and set SCHED_FIFO with 'priority' (0 = normal scheduling).
+ * Returns the resulting state, with the reason for anything that could not be
+ * applied (e.g. missing CAP_SYS_NICE for real-time priority).
+ */
+static inline std::string apply(const std::vector<int> &cores, int priority) {
+#if defined(__linux__)
+	std::string errors;
+
+	if (!cores.empty()) {
+		cpu_set_t set;
+		CPU_ZERO(&set);
+
+		for (auto core : cores) {
+			if ((core >= 0) && (core < CPU_SETSIZE)) {
+				CPU_SET(core, &set);
+			}
+		}
+
+		if (auto error = pthread_setaffinity_np(pthread_self(), sizeof(set), &set); error != 0) {
+			errors += std::string("; affinity failed: ") + strerror(error);
+		}
+	}
+
+	int policy;
+	struct sched_param param;
+
+	// Don't touch normal scheduling unless it needs to change.
+	if ((pthread_getschedparam(pthread_self(), &policy, &param) != 0) || (priority > 0) || (policy != SCHED_OTHER)) {
+		param.sched_priority = priority;
+
+		if (auto error
+			= pthread_setschedparam(pthread_self(), (priority > 0) ? (SCHED_FIFO) : (SCHED_OTHER), &param);
+			error != 0) {
+			errors += std::string("; priority failed: ") + strerror(error);
+		}
+	}
+
+	return (describe() + errors);
+#else
+	(void) cores;
+	(void) priority;
+
+	return (describe());
+#endif
+}
+
+} // namespace ThreadAffinity
+
+#endif // THREAD_AFFINITY_HPP
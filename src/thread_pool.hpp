@@ -0,0 +1,99 @@
+#ifndef THREAD_POOL_HPP
+#define THREAD_POOL_HPP
+
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * Fixed-size pool of worker threads executing tasks in submission order.
+ * Destruction waits for all queued tasks to complete.
+ */
+class ThreadPool {
+public:
+	explicit ThreadPool(size_t threadsNumber) {
+		threadsNumber = std::max<size_t>(threadsNumber, 1);
+
+		for (size_t i = 0; i < threadsNumber; i++) {
+			workers.emplace_back(&ThreadPool::threadRun, this);
+		}
+	}
+
+	~ThreadPool() {
+		{
+			std::scoped_lock lock(queueLock);
+			stopRequested = true;
+		}
+
+		queueCond.notify_all();
+
+		for (auto &worker : workers) {
+			worker.join();
+		}
+	}
+
+	ThreadPool(const ThreadPool &) = delete;
+	ThreadPool &operator=(const ThreadPool &) = delete;
+
+	size_t size() const {
+		return (workers.size());
+	}
+
+	template<typename Function>
+	auto submit(Function &&function) -> std::future<decltype(function())> {
+		using Result = decltype(function());
+
+		auto task   = std::make_shared<std::packaged_task<Result()>>(std::forward<Function>(function));
+		auto result = task->get_future();
+
+		{
+			std::scoped_lock lock(queueLock);
+			tasks.emplace_back([task]() {
+				(*task)();
+			});
+		}
+
+		queueCond.notify_one();
+
+		return (result);
+	}
+
+private:
+	std::vector<std::thread> workers;
+	std::deque<std::function<void()>> tasks;
+	std::mutex queueLock;
+	std::condition_variable queueCond;
+	bool stopRequested{false};
+
+	void threadRun() {
+		while (true) {
+			std::function<void()> task;
+
+			{
+				std::unique_lock lock(queueLock);
+
+				queueCond.wait(lock, [this]() {
+					return (stopRequested || !tasks.empty());
+				});
+
+				if (tasks.empty()) {
+					// Only stop once everything queued is done.
+					return;
+				}
+
+				task = std::move(tasks.front());
+				tasks.pop_front();
+			}
+
+			task();
+		}
+	}
+};
+
+#endif // THREAD_POOL_HPP
@@ -0,0 +1,120 @@
+#ifndef TIMESTAMP_RESET_HPP
+#define TIMESTAMP_RESET_HPP
+
+#include <libcaer/events/common.h>
+#include <libcaer/events/special.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+
+/**
+ * Locating a TIMESTAMP_RESET inside a container, instead of relying on it
+ * arriving alone in its own special packet.
+ */
+namespace TimestampReset {
+
+// Low byte of a special event's data: valid mark (bit 0) and type (bits 1-7).
+static constexpr uint32_t EVENT_KEY  = (TIMESTAMP_RESET << SPECIAL_TYPE_SHIFT) | VALID_MARK_MASK;
+static constexpr uint32_t EVENT_MASK = (SPECIAL_TYPE_MASK << SPECIAL_TYPE_SHIFT) | VALID_MARK_MASK;
+
+static constexpr int32_t BLOCK_SIZE = 16;
+
+/**
+ * Index of the first valid TIMESTAMP_RESET in a special packet, -1 if none.
+ *
+ * Special events are two 32-bit words (data, timestamp). Blocks of events are
+ * reduced to a single 'any match' flag without branches, which compilers
+ * vectorize; only a block with a match is searched for the exact index.
+ */
+static inline int32_t find(caerEventPacketHeaderConst special) {
+	if ((special == nullptr) || (caerEventPacketHeaderGetEventType(special) != SPECIAL_EVENT)) {
+		return (-1);
+	}
+
+	auto eventsNumber = caerEventPacketHeaderGetEventNumber(special);
+	if (eventsNumber <= 0) {
+		return (-1);
+	}
+
+	// Data words are little-endian, like the host on all supported platforms.
+	auto words = reinterpret_cast<const uint32_t *>(
+		caerSpecialEventPacketGetEventConst(reinterpret_cast<caerSpecialEventPacketConst>(special), 0));
+
+	int32_t blockStart = 0;
+
+	for (; (blockStart + BLOCK_SIZE) <= eventsNumber; blockStart += BLOCK_SIZE) {
+		const uint32_t *block = words + (2 * blockStart);
+
+		uint32_t match = 0;
+
+		for (int32_t i = 0; i < BLOCK_SIZE; i++) {
+			match |= static_cast<uint32_t>((block[2 * i] & EVENT_MASK) == EVENT_KEY);
+		}
+
+		if (match != 0) {
+			break;
+		}
+	}
+
+	for (int32_t i = blockStart; i < eventsNumber; i++) {
+		if ((words[2 * i] & EVENT_MASK) == EVENT_KEY) {
+			return (i);
+		}
+	}
+
+	return (-1);
+}
+
+/**
+ * Index of the first event of a packet that is in the new timebase, when a
+ * TIMESTAMP_RESET arrived in the same container: the first point where the
+ * timestamp goes back. Without one, the whole packet is on one side; it is in
+ * the new timebase if it starts before 'lastTimestamp', the newest timestamp
+ * seen before the reset (INT64_MAX if unknown).
+ */
+static inline int32_t split(caerEventPacketHeaderConst packet, int64_t lastTimestamp) {
+	auto eventsNumber = caerEventPacketHeaderGetEventNumber(packet);
+	if (eventsNumber <= 0) {
+		return (0);
+	}
+
+	auto eventSize = caerEventPacketHeaderGetEventSize(packet);
+	auto tsOffset  = caerEventPacketHeaderGetEventTSOffset(packet);
+	auto events    = reinterpret_cast<const uint8_t *>(caerGenericEventGetEvent(packet, 0));
+
+	int32_t previous;
+	memcpy(&previous, events + tsOffset, sizeof(int32_t));
+
+	for (int32_t i = 1; i < eventsNumber; i++) {
+		int32_t timestamp;
+		memcpy(&timestamp, events + (i * eventSize) + tsOffset, sizeof(int32_t));
+
+		if (timestamp < previous) {
+			return (i);
+		}
+
+		previous = timestamp;
+	}
+
+	auto first = caerGenericEventGetTimestamp64(caerGenericEventGetEvent(packet, 0), packet);
+
+	return ((first < lastTimestamp) ? (0) : (eventsNumber));
+}
+
+/**
+ * Newest timestamp among the events with index below 'end' (the last of them),
+ * INT64_MIN if there are none.
+ */
+static inline int64_t newest(caerEventPacketHeaderConst packet, int32_t end = INT32_MAX) {
+	auto eventsNumber = std::min(end, caerEventPacketHeaderGetEventNumber(packet));
+	if (eventsNumber <= 0) {
+		return (INT64_MIN);
+	}
+
+	return (caerGenericEventGetTimestamp64(caerGenericEventGetEvent(packet, eventsNumber - 1), packet));
+}
+
+} // namespace TimestampReset
+
+#endif // TIMESTAMP_RESET_HPP